@@ -0,0 +1,159 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/binaryconfig.hpp>
+#include <magnet/exception.hpp>
+#include <fstream>
+#include <cstring>
+
+namespace dynamo {
+  namespace binary {
+    namespace {
+      const char magic[8] = {'D', 'Y', 'N', 'A', 'M', 'O', 'B', '\0'};
+      const uint32_t byteOrderMark = 0x01020304;
+
+      inline size_t padded(size_t size) { return (size + 7) & ~size_t(7); }
+    }
+
+    bool isBinaryFile(const std::string& fileName)
+    { return (fileName.size() >= 4) && (fileName.compare(fileName.size() - 4, 4, ".bin") == 0); }
+
+    Reader::Reader(const std::string& fileName)
+    {
+      try {
+	_file.open(fileName);
+      } catch (std::exception& err)
+	{ M_throw() << "Failed to map the binary configuration file " << fileName << "\n" << err.what(); }
+
+      if (_file.size() < sizeof(FileHeader))
+	M_throw() << "The file " << fileName << " is too small to be a binary configuration file";
+
+      std::memcpy(&_header, _file.data(), sizeof(FileHeader));
+
+      if (std::memcmp(_header.magic, magic, sizeof(magic)))
+	M_throw() << "The file " << fileName << " is not a binary configuration file";
+
+      if (_header.byteOrder != byteOrderMark)
+	M_throw() << "The binary configuration file " << fileName << " was written on a machine with a different byte order";
+
+      if (_header.version != formatVersion)
+	M_throw() << "The binary configuration file " << fileName << " has a format version of "
+		  << _header.version << ", but the current version is " << formatVersion;
+
+      if (_header.ndim != NDIM)
+	M_throw() << "The binary configuration file " << fileName << " was written for " << _header.ndim
+		  << " dimensions, but this is a " << NDIM << " dimensional build";
+
+      size_t offset = padded(sizeof(FileHeader) + _header.xmlSize);
+      for (size_t i(0); i < _header.blockCount; ++i)
+	{
+	  if (offset + sizeof(BlockHeader) > _file.size())
+	    M_throw() << "The binary configuration file " << fileName << " is truncated";
+
+	  BlockHeader header;
+	  std::memcpy(&header, _file.data() + offset, sizeof(BlockHeader));
+	  offset += sizeof(BlockHeader);
+
+	  if (offset + header.nameSize > _file.size())
+	    M_throw() << "The binary configuration file " << fileName << " is truncated";
+
+	  Block block;
+	  block.type = BlockType(header.type);
+	  block.name = std::string(_file.data() + offset, header.nameSize);
+	  offset = padded(offset + header.nameSize);
+
+	  if (offset + header.dataSize > _file.size())
+	    M_throw() << "The binary configuration file " << fileName << " is truncated";
+
+	  block.data = _file.data() + offset;
+	  block.size = header.dataSize;
+	  offset = padded(offset + header.dataSize);
+
+	  _blocks.push_back(block);
+	}
+    }
+
+    std::string
+    Reader::getXML() const
+    { return std::string(_file.data() + sizeof(FileHeader), _header.xmlSize); }
+
+    const Reader::Block*
+    Reader::find(BlockType type, const std::string& name) const
+    {
+      for (const Block& block : _blocks)
+	if ((block.type == type) && (block.name == name))
+	  return &block;
+      return nullptr;
+    }
+
+    std::vector<char>&
+    Writer::addBlock(BlockType type, const std::string& name, size_t size)
+    {
+      _blocks.push_back(Block());
+      _blocks.back().type = type;
+      _blocks.back().name = name;
+      _blocks.back().data.resize(size);
+      return _blocks.back().data;
+    }
+
+    void
+    Writer::write(const std::string& fileName, const std::string& xml, size_t N) const
+    {
+      std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+      if (!file)
+	M_throw() << "Failed to open " << fileName << " for writing";
+
+      const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      size_t offset = 0;
+      auto append = [&](const char* data, size_t size) {
+	file.write(data, size);
+	offset += size;
+	file.write(zeros, padded(offset) - offset);
+	offset = padded(offset);
+      };
+
+      FileHeader header;
+      std::memcpy(header.magic, magic, sizeof(magic));
+      header.version = formatVersion;
+      header.byteOrder = byteOrderMark;
+      header.ndim = NDIM;
+      header.blockCount = _blocks.size();
+      header.N = N;
+      header.xmlSize = xml.size();
+
+      //The XML is placed directly after the header
+      file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+      offset += sizeof(FileHeader);
+      append(xml.data(), xml.size());
+
+      for (const Block& block : _blocks)
+	{
+	  BlockHeader blockHeader;
+	  blockHeader.type = block.type;
+	  blockHeader.nameSize = block.name.size();
+	  blockHeader.dataSize = block.data.size();
+	  file.write(reinterpret_cast<const char*>(&blockHeader), sizeof(BlockHeader));
+	  offset += sizeof(BlockHeader);
+	  append(block.name.data(), block.name.size());
+	  append(block.data.data(), block.data.size());
+	}
+
+      if (!file)
+	M_throw() << "Failed while writing the binary configuration file " << fileName;
+    }
+  }
+}
@@ -0,0 +1,172 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/math/vector.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+
+namespace dynamo {
+  /*! \brief Support for the binary configuration file format.
+
+    Large configurations spend most of their loading time
+    decompressing and parsing the text of the particle data. A binary
+    configuration file (selected by the ".bin" extension) instead
+    stores the configuration as follows:
+
+    - A \ref FileHeader.
+    - The XML configuration, without any per-particle data (the
+      ParticleData tag is empty and the capture maps are missing).
+    - A sequence of data blocks, each a \ref BlockHeader followed by
+      a name (e.g., the Property or Interaction name) and then the
+      raw data.
+
+    Every section starts on an 8 byte boundary. The file is memory
+    mapped when loaded, so the blocks are read in place without any
+    parsing. The data is written in the native byte order and this
+    is checked when the file is loaded.
+  */
+  namespace binary {
+    /*! \brief The version of the binary layout (the XML has its own
+        version attribute).
+     */
+    const uint32_t formatVersion = 1;
+
+    typedef enum : uint32_t {
+      PARTICLES = 1, //!< A ParticleRecord for each particle.
+      ORIENTATIONS = 2, //!< An OrientationRecord for each particle.
+      PROPERTY = 3, //!< A double for each particle, named after the ParticleProperty.
+      CAPTUREMAP = 4 //!< A CaptureRecord for each entry, named after the ICapture Interaction.
+    } BlockType;
+
+    struct FileHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t byteOrder;
+      uint32_t ndim;
+      uint32_t blockCount;
+      uint64_t N;
+      uint64_t xmlSize;
+    };
+
+    struct BlockHeader
+    {
+      uint32_t type;
+      uint32_t nameSize;
+      uint64_t dataSize;
+    };
+
+    struct ParticleRecord
+    {
+      double position[NDIM];
+      double velocity[NDIM];
+      uint32_t ID;
+      uint32_t dynamic;
+    };
+
+    struct OrientationRecord
+    {
+      double orientation[NDIM + 1];
+      double angularVelocity[NDIM];
+    };
+
+    struct CaptureRecord
+    {
+      uint32_t ID1;
+      uint32_t ID2;
+      uint64_t value;
+    };
+
+    /*! \brief Test if a file name selects the binary format. */
+    bool isBinaryFile(const std::string& fileName);
+
+    /*! \brief A memory mapped binary configuration file. */
+    class Reader
+    {
+    public:
+      struct Block
+      {
+	BlockType type;
+	std::string name;
+	const char* data;
+	size_t size;
+
+	template<class T> const T* begin() const { return reinterpret_cast<const T*>(data); }
+	template<class T> const T* end() const { return reinterpret_cast<const T*>(data + size); }
+	template<class T> size_t count() const { return size / sizeof(T); }
+      };
+
+      /*! \brief Map the file and index its blocks.
+
+	This throws if the file is not a binary configuration file of
+	the current version, byte order and dimensionality.
+       */
+      Reader(const std::string& fileName);
+
+      size_t N() const { return _header.N; }
+
+      /*! \brief The XML section of the file. */
+      std::string getXML() const;
+
+      /*! \brief Find a block by its type and name.
+
+	\return The Block, or nullptr if there is no matching block
+	in the file.
+       */
+      const Block* find(BlockType type, const std::string& name = "") const;
+
+    private:
+      boost::iostreams::mapped_file_source _file;
+      FileHeader _header;
+      std::vector<Block> _blocks;
+    };
+
+    /*! \brief Collects the sections of a binary configuration file
+        and writes them out.
+     */
+    class Writer
+    {
+    public:
+      /*! \brief Add a new block to the file.
+
+	\return The buffer for the block data, which must be filled
+	before write() is called.
+       */
+      std::vector<char>& addBlock(BlockType type, const std::string& name, size_t size);
+
+      template<class T>
+      T* addBlock(BlockType type, const std::string& name, size_t count)
+      { return reinterpret_cast<T*>(addBlock(type, name, count * sizeof(T)).data()); }
+
+      void write(const std::string& fileName, const std::string& xml, size_t N) const;
+
+    private:
+      struct Block
+      {
+	BlockType type;
+	std::string name;
+	std::vector<char> data;
+      };
+
+      std::deque<Block> _blocks;
+    };
+  }
+}
@@ -49,6 +49,12 @@ namespace dynamo {
        "Sets the system time inbetween saving snapshots of the system.")
       ("snapshot-events", boost::program_options::value<size_t>(),
        "Sets the event count inbetween saving snapshots of the system.")
+      ("snapshot-async",
+       "Compress and write the snapshots in a background thread, so that the simulation continues while they are saved.")
+      ("ticker-async",
+       "Run the ticker plugins which only read a snapshot of the particles (e.g., MSDMultiTau, KEnergyTicker) in a background thread, so that the simulation continues while they collect data.")
+      ("sort-particles", boost::program_options::value<size_t>(),
+       "Reorder the particles in memory along a space filling curve every this many events, to improve the cache use of large systems.")
       ;
   
     opts.add(simopts);
@@ -90,6 +96,9 @@ namespace dynamo {
     Sim.loadXMLfile(filename.c_str());
     
     Sim.endEventCount = vm["events"].as<size_t>();
+
+    if (vm.count("sort-particles"))
+      Sim.particleSortInterval = vm["sort-particles"].as<size_t>();
   
     if (vm["events"].as<size_t>() 
 	> vm["print-events"].as<size_t>())
@@ -81,10 +81,18 @@ namespace dynamo {
 		 vm["config-file"].as<std::vector<std::string> >()[i]);
 
 	if (vm.count("snapshot"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+	  {
+	    shared_ptr<SysSnapshot> snapshot(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped")));
+	    snapshot->setAsync(vm.count("snapshot-async"));
+	    Simulations[i].systems.push_back(snapshot);
+	  }
 
 	if (vm.count("snapshot-events"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
+	  {
+	    shared_ptr<SysSnapshot> snapshot(new SysSnapshot(&(Simulations[i]), vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped")));
+	    snapshot->setAsync(vm.count("snapshot-async"));
+	    Simulations[i].systems.push_back(snapshot);
+	  }
 
 	Simulations[i].initialise();
 
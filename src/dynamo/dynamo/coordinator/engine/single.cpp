@@ -97,6 +97,10 @@ namespace dynamo {
 	(vm["config-file"].as<std::vector<std::string> >().size() != 1))
       M_throw() << "You must only provide one input file in single mode";
 
+    //Only a single simulation is running, so it may use the thread
+    //pool for its own work (including loading the configuration).
+    simulation.threadPool = &threads;
+
     setupSim(simulation, vm["config-file"].as<std::vector<std::string> >()[0]);
 
 #ifdef DYNAMO_visualizer
@@ -104,10 +108,18 @@ namespace dynamo {
 #endif
 
     if (vm.count("snapshot"))
-      simulation.systems.push_back(shared_ptr<System>(new SysSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotTimer", "%COUNT", !vm.count("unwrapped"))));
+      {
+	shared_ptr<SysSnapshot> snapshot(new SysSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotTimer", "%COUNT", !vm.count("unwrapped")));
+	snapshot->setAsync(vm.count("snapshot-async"));
+	simulation.systems.push_back(snapshot);
+      }
 
     if (vm.count("snapshot-events"))
-      simulation.systems.push_back(shared_ptr<System>(new SysSnapshot(&simulation, vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
+      {
+	shared_ptr<SysSnapshot> snapshot(new SysSnapshot(&simulation, vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped")));
+	snapshot->setAsync(vm.count("snapshot-async"));
+	simulation.systems.push_back(snapshot);
+      }
 
     simulation.initialise();
 
@@ -116,6 +128,9 @@ namespace dynamo {
     if (vm.count("ticker-period"))
       simulation.setTickerPeriod(vm["ticker-period"].as<double>());
 
+    if (vm.count("ticker-async") && (simulation.systems.find("SystemTicker") != simulation.systems.end()))
+      simulation.setTickerAsync(true);
+
   }
 
   void
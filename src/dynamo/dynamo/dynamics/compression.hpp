@@ -34,6 +34,11 @@ namespace dynamo {
     DynCompression(dynamo::Simulation*, double);
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;  
+    //The batched DynNewtonian sphere tests assume straight line trajectories
+    virtual void SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereInRoot(p1, ids, d, dt); }
+    virtual void SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereOutRoot(p1, ids, d, dt); }
     virtual std::pair<bool, double> getOffcentreSpheresCollision(const double offset1, const double diameter1, const double offset2, const double diameter2, const Particle& p1, const Particle& p2, double t_max, double maxdist) const;
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
     virtual PairEventData SmoothSpheresColl(const IntEvent&, const double&, const double&, const EEventType&) const;
@@ -149,6 +149,40 @@ namespace dynamo {
       }
   }
 
+  namespace {
+    //! A copy of a particle, in the configuration file units.
+    Particle configParticle(const Simulation& Sim, size_t i, bool applyBC)
+    {
+      Particle tmp(Sim.particles[i]);
+      if (applyBC) 
+	Sim.BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
+      
+      tmp.getVelocity() *= (1.0 / Sim.units.unitVelocity());
+      tmp.getPosition() *= (1.0 / Sim.units.unitLength());
+      return tmp;
+    }
+
+    template<class Properties>
+    void outputPtXML(magnet::xml::XmlStream& XML, size_t i, const Particle& tmp, 
+		     const Properties& properties, const Dynamics::rotData* rot)
+    {
+      XML << magnet::xml::tag("Pt");
+      for (const auto& property : properties)
+	property->outputParticleXMLData(XML, i);
+      XML << tmp;
+
+      if (rot)
+	XML << magnet::xml::tag("O")
+	    << rot->angularVelocity
+	    << magnet::xml::endtag("O")
+	    << magnet::xml::tag("U")
+	    << rot->orientation
+	    << magnet::xml::endtag("U") ;
+
+      XML << magnet::xml::endtag("Pt");
+    }
+  }
+
   void 
   Dynamics::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const
   {
@@ -158,32 +192,41 @@ namespace dynamo {
       XML << magnet::xml::attr("OrientationData") << "Y";
 
     for (size_t i = 0; i < Sim->N(); ++i)
-      {
-	Particle tmp(Sim->particles[i]);
-	if (applyBC) 
-	  Sim->BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
-      
-	tmp.getVelocity() *= (1.0 / Sim->units.unitVelocity());
-	tmp.getPosition() *= (1.0 / Sim->units.unitLength());
-      
-	XML << magnet::xml::tag("Pt");
-	Sim->_properties.outputParticleXMLData(XML, i);
-	XML << tmp;
-
-	if (hasOrientationData())
-	  XML << magnet::xml::tag("O")
-	      << orientationData[i].angularVelocity
-	      << magnet::xml::endtag("O")
-	      << magnet::xml::tag("U")
-	      << orientationData[i].orientation
-	      << magnet::xml::endtag("U") ;
-
-	XML << magnet::xml::endtag("Pt");
-      }
+      outputPtXML(XML, i, configParticle(*Sim, i, applyBC), Sim->_properties,
+		  hasOrientationData() ? &orientationData[i] : NULL);
   
     XML << magnet::xml::endtag("ParticleData");
   }
 
+  std::function<void(magnet::xml::XmlStream&)>
+  Dynamics::copyParticleXMLData(bool applyBC) const
+  {
+    shared_ptr<std::vector<Particle> > particles(new std::vector<Particle>);
+    particles->reserve(Sim->N());
+    for (size_t i = 0; i < Sim->N(); ++i)
+      particles->push_back(configParticle(*Sim, i, applyBC));
+
+    //Only the per-particle properties write any particle data
+    shared_ptr<std::vector<shared_ptr<const Property> > > properties(new std::vector<shared_ptr<const Property> >);
+    for (const shared_ptr<Property>& property : Sim->_properties)
+      if (std::dynamic_pointer_cast<const ParticleProperty>(property))
+	properties->push_back(shared_ptr<const Property>(new ParticleProperty(static_cast<const ParticleProperty&>(*property))));
+
+    shared_ptr<std::vector<rotData> > orientations(new std::vector<rotData>(orientationData));
+
+    return [particles, properties, orientations](magnet::xml::XmlStream& XML) {
+      XML << magnet::xml::tag("ParticleData");
+  
+      if (!orientations->empty())
+	XML << magnet::xml::attr("OrientationData") << "Y";
+
+      for (size_t i = 0; i < particles->size(); ++i)
+	outputPtXML(XML, i, (*particles)[i], *properties, orientations->empty() ? NULL : &(*orientations)[i]);
+  
+      XML << magnet::xml::endtag("ParticleData");
+    };
+  }
+
   double 
   Dynamics::getParticleKineticEnergy(const Particle& part) const
   {
@@ -208,6 +251,22 @@ namespace dynamo {
     return 0.5 * energy;
   }
 
+  void
+  Dynamics::SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    dt.resize(ids.size());
+    for (size_t i(0); i < ids.size(); ++i)
+      dt[i] = SphereSphereInRoot(p1, Sim->particles[ids[i]], d[i]);
+  }
+
+  void
+  Dynamics::SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    dt.resize(ids.size());
+    for (size_t i(0); i < ids.size(); ++i)
+      dt[i] = SphereSphereOutRoot(p1, Sim->particles[ids[i]], d[i]);
+  }
+
   double 
   Dynamics::getSystemKineticEnergy() const
   {
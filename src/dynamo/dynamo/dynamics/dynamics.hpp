@@ -21,6 +21,7 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/math/quaternion.hpp>
+#include <functional>
 
 namespace xml { class XmlStream; }
 namespace dynamo {
@@ -96,6 +97,17 @@ namespace dynamo {
      */
     void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const;
 
+    /*! \brief Copies the particle data so that it can be written
+      later, e.g., in a background thread while the simulation
+      continues.
+
+      The returned function writes exactly what outputParticleXMLData
+      would have written at the time of this call. The particles are
+      copied in the configuration file units, so the per-particle
+      properties must already be rescaled to these units.
+     */
+    std::function<void(magnet::xml::XmlStream&)> copyParticleXMLData(bool applyBC) const;
+
     /*! \brief Returns the degrees of freedom per particle.
      */
     inline size_t getParticleDOF() const { return NDIM + 2 * hasOrientationData(); }
@@ -158,6 +170,24 @@ namespace dynamo {
      */
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const = 0;
 
+    /*! \brief Determines if and when a sphere will intersect with
+      each sphere in a list.
+
+      This is a batched form of SphereSphereInRoot, used to test a
+      particle against all of its neighbours at once. All of the
+      particles must be up to date. The default implementation
+      simply calls the pair test for each particle, but Dynamics
+      with simple trajectories should override this with a
+      vectorisable form.
+
+      \param p1 The particle to test.
+      \param ids The IDs of the particles to test against.
+      \param d The interaction diameter of each pair.
+      \param dt The times of the next event of each pair (or
+      HUGE_VAL if no event), this is resized to fit.
+     */
+    virtual void SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const;
+
     /*! \brief Determines if and when two spheres will stop intersecting.
      
       \param pd Some precomputed data about the event that is cached by
@@ -182,6 +212,14 @@ namespace dynamo {
      */
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const = 0;  
 
+    /*! \brief Determines if and when a sphere will stop intersecting
+      with each sphere in a list.
+
+      This is the batched form of SphereSphereOutRoot, see the
+      batched SphereSphereInRoot for more details.
+     */
+    virtual void SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const;
+
     /*! \brief Determines if two spheres are overlapping
      
       \param d The interaction distance.
@@ -691,6 +729,9 @@ namespace dynamo {
     const std::vector<rotData>& getCompleteRotData() const
     { return orientationData; }
 
+    std::vector<rotData>& getCompleteRotData()
+    { return orientationData; }
+
     /*! \brief Used to test if the dynamics has orientation data
        available.
      */
@@ -34,6 +34,11 @@ namespace dynamo {
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;
+    //The batched DynNewtonian sphere tests assume straight line trajectories
+    virtual void SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereInRoot(p1, ids, d, dt); }
+    virtual void SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereOutRoot(p1, ids, d, dt); }
     virtual void streamParticle(Particle&, const double&) const;
     virtual double getSquareCellCollision2(const Particle&, const Vector &, const Vector &) const;
     virtual int getSquareCellCollision3(const Particle&, const Vector &, const Vector &) const;
@@ -45,7 +45,7 @@ namespace dynamo {
 	    for (magnet::xml::Node entry_node = map_node.fastGetNode("Contact"); entry_node.valid(); ++entry_node)
 	      map[detail::CaptureMap::key_type(entry_node.getAttribute("ID1").as<size_t>(), entry_node.getAttribute("ID2").as<size_t>())]
 		= entry_node.getAttribute("State").as<size_t>();
-	    _W.push_back(std::make_pair(map, WData(distance, Wval)));
+	    _W.push_back(std::make_pair(detail::CaptureMapKey(map), WData(distance, Wval)));
 	  }
       }
   }
@@ -58,7 +58,7 @@ namespace dynamo {
 	<< magnet::xml::attr("Interaction") << _interaction_name
 	<< magnet::xml::tag("Potential");
     
-    for (const auto entry : _W)
+    for (const auto& entry : _W)
       {
 	XML << magnet::xml::tag("Map")
 	    << magnet::xml::attr("W") << entry.second._wval
@@ -119,14 +119,11 @@ namespace dynamo {
     double MCDeltaKE = deltaKE;
 
     //If there are entries for the current and possible future energy, then take them into account
-    detail::CaptureMap contact_map = *_interaction;
-    
     //Add the current bias potential
-    MCDeltaKE += W(contact_map) * Sim->ensemble->getEnsembleVals()[2];
+    MCDeltaKE += W(*_interaction) * Sim->ensemble->getEnsembleVals()[2];
 
     //subtract the possible bias potential in the new state
-    contact_map[detail::CaptureMap::key_type(particle1, particle2)] = newstate;
-    MCDeltaKE -= W(contact_map) * Sim->ensemble->getEnsembleVals()[2];
+    MCDeltaKE -= W(*_interaction, detail::CaptureMap::key_type(particle1, particle2), newstate) * Sim->ensemble->getEnsembleVals()[2];
 
     //Test if the deformed energy change allows a capture event to occur
     double sqrtArg = retVal.rvdot * retVal.rvdot + 2.0 * R2 * MCDeltaKE / mu;
@@ -181,44 +178,40 @@ namespace dynamo {
     size_t applicable_tethers = 0;
     double accumilated_W = 0;
 
-    for (auto tethermap : _W)
-      {
-	auto il = tethermap.first.begin();
-	auto ir = map.begin();
-	
-	size_t distance = 0;
-	while (il != tethermap.first.end() && ir != map.end())
-	  {
-	    if ((*il).first < (*ir).first)
-	      {
-		++il;
-		++distance;
-	      }
-	    else if ((*ir).first < (*il).first)
-	      {
-		++ir;
-		++distance;
-	      }
-	    else
-	      {
-		++il;
-		++ir;
-	      }
-	  }
+    for (const auto& tethermap : _W)
+      if (distance(tethermap.first, map) <= tethermap.second._distance)
+	{
+	  ++applicable_tethers;
+	  accumilated_W += tethermap.second._wval;
+	}
 
-	while (il != tethermap.first.end())
-	  {
-	    ++il;
-	    ++distance;
-	  }
+    return accumilated_W / (applicable_tethers + (applicable_tethers==0));
+  }
 
-	while (ir != map.end())
+  double 
+  DynNewtonianMCCMap::W(const detail::CaptureMap& map, const detail::PairKey& key, const size_t newstate) const
+  {
+    //Only the presence of the pair in the map can change the
+    //distances, as the distance only counts the pairs
+    const bool wasCaptured = map.count(key);
+    const bool isCaptured = newstate;
+
+    size_t applicable_tethers = 0;
+    double accumilated_W = 0;
+    for (const auto& tethermap : _W)
+      {
+	size_t dist = distance(tethermap.first, map);
+	if (wasCaptured != isCaptured)
 	  {
-	    ++ir;
-	    ++distance;
+	    //The pair either joins or leaves the map, which moves it
+	    //closer to the tether if the tether holds the pair
+	    if (tethermap.first.contains(key) == isCaptured)
+	      --dist;
+	    else
+	      ++dist;
 	  }
 
-	if (distance <= tethermap.second._distance)
+	if (dist <= tethermap.second._distance)
 	  {
 	    ++applicable_tethers;
 	    accumilated_W += tethermap.second._wval;
@@ -228,4 +221,18 @@ namespace dynamo {
     return accumilated_W / (applicable_tethers + (applicable_tethers==0));
   }
 
+  size_t
+  DynNewtonianMCCMap::distance(const detail::CaptureMapKey& tether, const detail::CaptureMap& map)
+  {
+    //The distance is the number of pairs in only one of the maps
+    if (tether.hash() == map.hash() && tether.size() == map.size())
+      return 0;
+
+    size_t shared = 0;
+    for (const auto& entry : tether)
+      shared += map.count(entry.first);
+
+    return tether.size() + map.size() - 2 * shared;
+  }
+
 }
@@ -50,6 +50,16 @@ namespace dynamo {
 
     double W(const detail::CaptureMap& map) const;
 
+    /*! \brief The bias potential of the map, if the state of one
+        pair were changed to newstate.
+
+      This avoids copying the capture map to test a transition.
+     */
+    double W(const detail::CaptureMap& map, const detail::PairKey& key, size_t newstate) const;
+
+    //! \brief The number of pairs which are captured in only one of the maps.
+    static size_t distance(const detail::CaptureMapKey& tether, const detail::CaptureMap& map);
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& ) const;
   };
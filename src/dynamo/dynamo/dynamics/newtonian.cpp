@@ -78,6 +78,41 @@ namespace dynamo {
     return magnet::intersection::ray_sphere(r12, v12, d);
   }
   
+  void
+  DynNewtonian::loadBatch(const Particle& p1, const std::vector<size_t>& ids) const
+  {
+    _batchR2.resize(ids.size());
+    _batchRV.resize(ids.size());
+    _batchV2.resize(ids.size());
+
+    for (size_t i(0); i < ids.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[ids[i]];
+	Vector r12 = p1.getPosition() - p2.getPosition();
+	Vector v12 = p1.getVelocity() - p2.getVelocity();
+	Sim->BCs->applyBC(r12, v12);
+	_batchR2[i] = r12.nrm2();
+	_batchRV[i] = (r12 | v12);
+	_batchV2[i] = v12.nrm2();
+      }
+  }
+
+  void
+  DynNewtonian::SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    loadBatch(p1, ids);
+    dt.resize(ids.size());
+    magnet::intersection::ray_sphere(_batchR2.data(), _batchRV.data(), _batchV2.data(), d.data(), dt.data(), ids.size());
+  }
+
+  void
+  DynNewtonian::SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    loadBatch(p1, ids);
+    dt.resize(ids.size());
+    magnet::intersection::ray_sphere<true>(_batchR2.data(), _batchRV.data(), _batchV2.data(), d.data(), dt.data(), ids.size());
+  }
+
   double
   DynNewtonian::SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const
   {
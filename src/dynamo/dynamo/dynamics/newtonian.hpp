@@ -38,6 +38,8 @@ namespace dynamo {
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;  
+    virtual void SphereSphereInRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const;
+    virtual void SphereSphereOutRoot(const Particle& p1, const std::vector<size_t>& ids, const std::vector<double>& d, std::vector<double>& dt) const;
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
     virtual double CubeCubeInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual bool cubeOverlap(const Particle& p1, const Particle& p2, const double d) const;
@@ -71,6 +73,14 @@ namespace dynamo {
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
+    /*! \brief Loads the relative motion of a batch of particle
+        pairs into _batchR2, _batchRV and _batchV2.
+     */
+    void loadBatch(const Particle& p1, const std::vector<size_t>& ids) const;
+
+    //! \brief Storage for the batched sphere tests (R.nrm2(), R|V and V.nrm2() for each pair).
+    mutable std::vector<double> _batchR2, _batchRV, _batchV2;
+
     mutable long double lastAbsoluteClock;
     mutable unsigned int lastCollParticle1;
     mutable unsigned int lastCollParticle2;
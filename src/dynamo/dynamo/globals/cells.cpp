@@ -25,6 +25,7 @@
 #include <dynamo/BC/LEBC.hpp>
 #include <dynamo/ranges/IDRangeList.hpp>
 #include <dynamo/dynamics/compression.hpp>
+#include <dynamo/locals/local.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cstdio>
@@ -37,7 +38,10 @@ namespace dynamo {
     _cellDimension(1,1,1),
     _inConfig(true),
     _oversizeCells(1.0),
-    overlink(1)
+    overlink(1),
+    _sparse(false),
+    _morton(false),
+    _indexLocals(false)
   {
     globName = name;
     dout << "Cells Loaded" << std::endl;
@@ -48,7 +52,9 @@ namespace dynamo {
     _cellDimension(1,1,1),
     _inConfig(true),
     _oversizeCells(1.0),
-    overlink(1)
+    overlink(1),
+    _sparse(false),
+    _indexLocals(false)
   {
     operator<<(XML);
 
@@ -69,6 +75,28 @@ namespace dynamo {
     
     if (_oversizeCells < 1.0)
       M_throw() << "You must specify an Oversize greater than 1.0, otherwise your cells are too small!";
+
+    if (XML.hasAttribute("Storage"))
+      {
+	const std::string storage = XML.getAttribute("Storage");
+	if (storage == "Sparse")
+	  _sparse = true;
+	else if (storage == "Dense")
+	  _sparse = false;
+	else
+	  M_throw() << "Unknown cell Storage type \"" << storage << "\", must be Dense or Sparse";
+      }
+
+    if (XML.hasAttribute("Ordering"))
+      {
+	const std::string ordering = XML.getAttribute("Ordering");
+	if (ordering == "Morton")
+	  _morton = true;
+	else if (ordering == "RowMajor")
+	  _morton = false;
+	else
+	  M_throw() << "Unknown cell Ordering \"" << ordering << "\", must be RowMajor or Morton";
+      }
     
     globName = XML.getAttribute("Name");
     
@@ -127,6 +155,27 @@ namespace dynamo {
     for (auto cellIndex : _ordering.getSurroundingIndices(newCenterNBCellCoord, steps))
       for (const size_t& next : _cellData.getCellContents(cellIndex))
 	_sigNewNeighbour(part, next);
+
+    //Check for Locals which are in the new cell but not the old one
+    if (_indexLocals)
+      {
+	const LocalRange oldLocals = getCellLocals(oldCellIndex);
+	auto oldLocal = oldLocals.begin();
+	for (const size_t& newLocal : getCellLocals(_ordering.toIndex(newCellCoord)))
+	  {
+	    while ((oldLocal != oldLocals.end()) && (*oldLocal < newLocal)) ++oldLocal;
+	    if ((oldLocal == oldLocals.end()) || (*oldLocal != newLocal))
+	      _sigNewLocal(part, newLocal);
+	  }
+
+	//Only cache the Locals of the occupied sparse cells
+	if (_sparse)
+	  {
+	    const auto oldContents = _cellData.getCellContents(oldCellIndex);
+	    if (oldContents.begin() == oldContents.end())
+	      _sparseCellLocals.erase(oldCellIndex);
+	  }
+      }
   
     //Push the next virtual event, this is the reason the scheduler
     //doesn't need a second callback
@@ -167,6 +216,8 @@ namespace dynamo {
     
     if (overlink > 1)   XML << magnet::xml::attr("OverLink") << overlink;
     if (_oversizeCells != 1.0) XML << magnet::xml::attr("Oversize") << _oversizeCells;
+    if (_sparse) XML << magnet::xml::attr("Storage") << "Sparse";
+    if (_morton) XML << magnet::xml::attr("Ordering") << "Morton";
     
     XML << range
 	<< magnet::xml::endtag("Global");
@@ -189,7 +240,7 @@ namespace dynamo {
 	_cellDimension[iDim] = _cellLatticeWidth[iDim] + (_cellLatticeWidth[iDim] - maxdiam) * overlap;
 	_cellOffset[iDim] = -(_cellLatticeWidth[iDim] - maxdiam) * overlap * 0.5;
       }
-    _ordering = Ordering(cellCount);
+    _ordering = Ordering(cellCount, _morton);
 
     buildCells();
 
@@ -200,10 +251,11 @@ namespace dynamo {
   void GCells::buildCells()
   {
     _cellData.clear();
+    _cellData.getCellList().setSparse(_sparse);
     _cellData.resize(_ordering.length(), Sim->particles.size()); //Empty Cells created!
 
     dout << "Cells " << _ordering.getDimensions()[0] << "," << _ordering.getDimensions()[1] << "," << _ordering.getDimensions()[2]
-	 << "\nCell containers = " << _ordering.length()
+	 << "\nCell containers = " << _ordering.length() << (_sparse ? " (sparse)" : "") << (_morton ? " (Morton ordered)" : "")
 	 << "\nCell Offset "
 	 << _cellOffset[0] / Sim->units.unitLength() << ","
 	 << _cellOffset[1] / Sim->units.unitLength() << ","
@@ -231,6 +283,136 @@ namespace dynamo {
 	Particle& p = Sim->particles[pid];
 	_cellData.add(_ordering.toIndex(getCellCoords(p.getPosition())), pid);
       }
+
+    if (_sparse)
+      dout << "Occupied cells " << _cellData.getCellList().allocated(_ordering.length()) << std::endl;
+
+    buildCellLocals();
+  }
+
+  void
+  GCells::buildCellLocals()
+  {
+    _cellLocalsStart.clear();
+    _cellLocals.clear();
+    _sparseCellLocals.clear();
+
+    _indexLocals = !Sim->locals.empty() && !std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs);
+    if (!_indexLocals || _sparse)
+      return;
+
+    //Each Local is only tested against the blocks of cells it may
+    //overlap, so the cost scales with the cells it touches rather
+    //than with every cell in the system
+    std::vector<std::vector<size_t> > cellLocals(_ordering.length());
+    const std::array<size_t, 3> first = {{0, 0, 0}};
+    for (size_t ID(0); ID < Sim->locals.size(); ++ID)
+      addLocalToCells(ID, first, _ordering.getDimensions(), cellLocals);
+
+    _cellLocalsStart.reserve(_ordering.length() + 1);
+    for (const std::vector<size_t>& locals : cellLocals)
+      {
+	_cellLocalsStart.push_back(_cellLocals.size());
+	_cellLocals.insert(_cellLocals.end(), locals.begin(), locals.end());
+      }
+    _cellLocalsStart.push_back(_cellLocals.size());
+
+    dout << "Locals registered per cell " << double(_cellLocals.size()) / _ordering.size()
+	 << " (of " << Sim->locals.size() << " Locals)" << std::endl;
+  }
+
+  void
+  GCells::addLocalToCells(const size_t ID, const std::array<size_t, 3>& first, const std::array<size_t, 3>& last,
+			  std::vector<std::vector<size_t> >& cellLocals) const
+  {
+    Vector origin, width;
+    getBlockBounds(first, last, origin, width);
+    //The Locals may not be initialised yet, so their position in
+    //the container is used as their ID
+    if (!Sim->locals[ID]->isInCell(origin, width))
+      return;
+
+    //Bisect the block along its longest side until single cells
+    //are reached
+    size_t splitDim(0);
+    for (size_t iDim(1); iDim < NDIM; ++iDim)
+      if (last[iDim] - first[iDim] > last[splitDim] - first[splitDim])
+	splitDim = iDim;
+
+    if (last[splitDim] - first[splitDim] == 1)
+      {
+	cellLocals[_ordering.toIndex(first)].push_back(ID);
+	return;
+      }
+
+    auto mid = first;
+    mid[splitDim] += (last[splitDim] - first[splitDim]) / 2;
+    auto lower = last;
+    lower[splitDim] = mid[splitDim];
+    addLocalToCells(ID, first, lower, cellLocals);
+    addLocalToCells(ID, mid, last, cellLocals);
+  }
+
+  void
+  GCells::getBlockBounds(const std::array<size_t, 3>& first, const std::array<size_t, 3>& last,
+			 Vector& origin, Vector& width) const
+  {
+    origin = calcPosition(first);
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      width[iDim] = (last[iDim] - first[iDim] - 1) * _cellLatticeWidth[iDim] + _cellDimension[iDim];
+    //Cells on the edge of the primary image may see Locals outside
+    //of it, or the periodic images of Locals on the opposite edge.
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      if ((first[iDim] == 0) || (last[iDim] == _ordering.getDimensions()[iDim]))
+	{
+	  origin[iDim] = -Sim->primaryCellSize[iDim];
+	  width[iDim] = 2 * Sim->primaryCellSize[iDim];
+	}
+  }
+
+  void
+  GCells::findCellLocals(size_t cellIndex, std::vector<size_t>& retlist) const
+  {
+    auto first = _ordering.toCoord(cellIndex);
+    //Morton ordering leaves gaps in the cell indices
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      if (first[iDim] >= _ordering.getDimensions()[iDim])
+	return;
+
+    auto last = first;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      ++last[iDim];
+
+    Vector origin, width;
+    getBlockBounds(first, last, origin, width);
+    for (size_t ID(0); ID < Sim->locals.size(); ++ID)
+      if (Sim->locals[ID]->isInCell(origin, width))
+	retlist.push_back(ID);
+  }
+
+  GCells::LocalRange
+  GCells::getCellLocals(size_t cellIndex) const
+  {
+    if (!_sparse)
+      return LocalRange(_cellLocals.begin() + _cellLocalsStart[cellIndex], _cellLocals.begin() + _cellLocalsStart[cellIndex + 1]);
+
+    auto it = _sparseCellLocals.find(cellIndex);
+    if (it == _sparseCellLocals.end())
+      {
+	it = _sparseCellLocals.insert(std::make_pair(cellIndex, std::vector<size_t>())).first;
+	findCellLocals(cellIndex, it->second);
+      }
+    return LocalRange(it->second.begin(), it->second.end());
+  }
+
+  void
+  GCells::getParticleLocals(const Particle& part, std::vector<size_t>& retlist) const
+  {
+    if (!_indexLocals)
+      return GNeighbourList::getParticleLocals(part, retlist);
+
+    const LocalRange locals = getCellLocals(_cellData.getCellID(part.getID()));
+    retlist.insert(retlist.end(), locals.begin(), locals.end());
   }
 
   std::array<size_t, 3>
@@ -271,6 +453,27 @@ namespace dynamo {
     return getParticleNeighbours(getCellCoords(vec), retlist);
   }
 
+  void
+  GCells::getDomainDecomposition(std::vector<std::vector<size_t> >& domains) const
+  {
+    const size_t ndomains = domains.size();
+    if (!ndomains) return;
+
+    //Slice along the dimension with the most cells, as this gives
+    //the thinnest domain boundaries relative to their volume.
+    const auto& dims = _ordering.getDimensions();
+    size_t sliceDim = 0;
+    for (size_t iDim(1); iDim < NDIM; ++iDim)
+      if (dims[iDim] > dims[sliceDim])
+	sliceDim = iDim;
+
+    for (const size_t& pid : *range)
+      {
+	const size_t slice = _ordering.toCoord(_cellData.getCellID(pid))[sliceDim];
+	domains[(slice * ndomains) / dims[sliceDim]].push_back(pid);
+      }
+  }
+
   double 
   GCells::getMaxSupportedInteractionLength() const
   {
@@ -83,6 +83,52 @@ namespace dynamo {
 
       size_t size() const { return _particleCell.size(); }
       void clear() { _particleCell.clear(); _cellcontents.clear(); }
+
+      CellList& getCellList() { return _cellcontents; }
+      const CellList& getCellList() const { return _cellcontents; }
+    };
+
+    /*! \brief A cell contents container which can switch between a
+        dense and a sparse storage of the cells at run time.
+
+	The dense storage (Vector_Multimap) allocates a set for every
+	cell, while the sparse storage (Hash_Multimap) only stores the
+	occupied cells.
+     */
+    template<typename InnerSet>
+    class SwitchableMultimap {
+      magnet::containers::Vector_Multimap<InnerSet> _dense;
+      magnet::containers::Hash_Multimap<InnerSet> _sparse;
+      bool _isSparse;
+
+    public:
+      typedef typename InnerSet::const_iterator const_iterator;
+      typedef magnet::containers::IteratorPairRange<const_iterator> RangeType;
+
+      SwitchableMultimap(): _isSparse(false) {}
+
+      //! Must be called while the container is empty.
+      void setSparse(bool val) { _isSparse = val; }
+      bool isSparse() const { return _isSparse; }
+
+      void erase(size_t cell, size_t particle) {
+	if (_isSparse) _sparse.erase(cell, particle); else _dense.erase(cell, particle);
+      }
+
+      void insert(size_t cell, size_t particle) {
+	if (_isSparse) _sparse.insert(cell, particle); else _dense.insert(cell, particle);
+      }
+
+      RangeType getKeyContents(const size_t cell) const {
+	return _isSparse ? _sparse.getKeyContents(cell) : _dense.getKeyContents(cell);
+      }
+
+      void resize(size_t cellcount) { if (!_isSparse) _dense.resize(cellcount); }
+
+      //! The number of cells which are allocated.
+      size_t allocated(size_t cellcount) const { return _isSparse ? _sparse.size() : cellcount; }
+
+      void clear() { _dense.clear(); _sparse.clear(); }
     };
   }
 
@@ -107,9 +153,31 @@ namespace dynamo {
     efficient however, the vector is much more cache friendly and can
     boost performance by 50% in cases where the cell has multiple
     particles inside of it.
+
+    By default every cell of the grid is allocated. For dilute or
+    inhomogeneous systems (e.g., a granular bed at the bottom of a
+    tall box under gravity) most of these cells are empty, and the
+    Storage="Sparse" attribute can be used to only store the occupied
+    cells in a hash map.
+
+    The cells are indexed in Row-Major order by default. The
+    Ordering="Morton" attribute indexes them along a Morton
+    (Z-order) curve instead, so that neighbouring cells are more
+    likely to be close together in memory. As the Morton ordering
+    pads the number of cells in each dimension up towards the next
+    power of two, it is best combined with sparse storage for boxes
+    which are much longer in one dimension.
+
+    \code
+    <Global Type="Cells" Name="SchedulerNBList" NeighbourhoodRange="1" Storage="Sparse" Ordering="Morton">
+      <IDRange Type="All"/>
+    </Global>
+    \endcode
    */
   class GCells: public GNeighbourList
   {
+    friend class GMultiCells;
+
   public:
     GCells(const magnet::xml::Node&, dynamo::Simulation*);
     GCells(Simulation*, const std::string&);
@@ -126,6 +194,16 @@ namespace dynamo {
 
     void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
     void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
+
+    /*! \brief Returns the Locals registered with the particle's
+        cell.
+     */
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const;
+
+    /*! \brief Splits the cells into slabs along the most finely
+        divided dimension, and returns the particles within each slab.
+     */
+    virtual void getDomainDecomposition(std::vector<std::vector<size_t> >&) const;
     
     virtual void operator<<(const magnet::xml::Node&);
 
@@ -136,10 +214,22 @@ namespace dynamo {
 
     void setConfigOutput(bool val) { _inConfig = val; }
 
+    /*! \brief Selects if only the occupied cells are stored.
+
+      This takes effect when the cells are next (re)initialised.
+     */
+    void setSparse(bool val) { _sparse = val; }
+
+    /*! \brief Selects if the cells are indexed in Morton order.
+
+      This takes effect when the cells are next (re)initialised.
+     */
+    void setMortonOrdering(bool val) { _morton = val; }
+
   protected:
     virtual void getParticleNeighbours(const std::array<size_t, 3>&, std::vector<size_t>&) const;
 
-    typedef magnet::containers::RowMajorOrdering<3> Ordering;
+    typedef magnet::containers::SwitchableOrdering<3> Ordering;
     Ordering _ordering;
 
     Vector _cellDimension;
@@ -149,12 +239,14 @@ namespace dynamo {
     bool _inConfig;
     double _oversizeCells;
     size_t overlink;
+    bool _sparse;
+    bool _morton;
 
 #ifdef DYNAMO_JUDY
-    detail::CellParticleList<magnet::containers::Vector_Multimap<magnet::containers::VectorSet<size_t>>, 
+    detail::CellParticleList<detail::SwitchableMultimap<magnet::containers::VectorSet<size_t>>, 
 			     magnet::containers::JudyMap<size_t, size_t>> _cellData;
 #else
-    detail::CellParticleList<magnet::containers::Vector_Multimap<magnet::containers::VectorSet<size_t>>, 
+    detail::CellParticleList<detail::SwitchableMultimap<magnet::containers::VectorSet<size_t>>, 
 			     std::unordered_map<size_t, size_t> > _cellData;
 #endif
     GCells(const GCells&);
@@ -166,6 +258,53 @@ namespace dynamo {
     void addCells(double);
     void buildCells();
 
+    /*! \brief Registers each Local with the cells where it may
+        generate events (see Local::isInCell).
+
+      The Locals of cell i are stored in _cellLocals, between the
+      offsets _cellLocalsStart[i] and _cellLocalsStart[i+1], sorted by
+      their ID. Cells on the edge of the primary image are stretched
+      across the whole system (and half a system width beyond it) in
+      that dimension, so that Locals placed on (or just outside of)
+      the edge of the simulation, and the periodic images of Locals
+      on the opposite edge, are found.
+
+      Locals are not indexed under Lees-Edwards boundary conditions,
+      where every particle is tested against every Local.
+
+      If the cells are sparse, the Locals of each cell are instead
+      found when a particle first enters it, and are cached in
+      _sparseCellLocals until the cell is empty again. The cache
+      therefore never holds more entries than there are occupied
+      cells.
+     */
+    void buildCellLocals();
+
+    //! Adds the IDs of the Locals which may generate events in the cell.
+    void findCellLocals(size_t cellIndex, std::vector<size_t>& retlist) const;
+
+    /*! \brief Adds a Local to each cell in the block [first, last)
+        where it may generate events.
+
+      The block is only subdivided while the Local reports it may
+      be inside it, which relies on Local::isInCell being true for
+      any box containing a box it is true for.
+     */
+    void addLocalToCells(size_t ID, const std::array<size_t, 3>& first, const std::array<size_t, 3>& last,
+			 std::vector<std::vector<size_t> >& cellLocals) const;
+
+    //! The box covered by the cells of the block [first, last).
+    void getBlockBounds(const std::array<size_t, 3>& first, const std::array<size_t, 3>& last,
+			Vector& origin, Vector& width) const;
+
+    typedef magnet::containers::IteratorPairRange<std::vector<size_t>::const_iterator> LocalRange;
+    LocalRange getCellLocals(size_t cellIndex) const;
+
+    bool _indexLocals;
+    std::vector<size_t> _cellLocalsStart;
+    std::vector<size_t> _cellLocals;
+    mutable std::unordered_map<size_t, std::vector<size_t> > _sparseCellLocals;
+
     Vector calcPosition(const size_t cellIndex, const Particle& part) const { return calcPosition(_ordering.toCoord(cellIndex), part);}
     Vector calcPosition(const std::array<size_t, 3>& coords, const Particle& part) const ;
     Vector calcPosition(const size_t cellIndex) const { return calcPosition(_ordering.toCoord(cellIndex));}
@@ -0,0 +1,337 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/globals/multicells.hpp>
+#include <dynamo/globals/globEvent.hpp>
+#include <dynamo/interactions/interaction.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dynamo {
+  GMultiCells::GMultiCells(dynamo::Simulation* nSim, const std::string& name):
+    GNeighbourList(nSim, "MultiCellNeighbourList")
+  {
+    globName = name;
+    dout << "MultiCells Loaded" << std::endl;
+  }
+
+  GMultiCells::GMultiCells(const magnet::xml::Node& XML, dynamo::Simulation* ptrSim):
+    GNeighbourList(ptrSim, "MultiCellNeighbourList")
+  {
+    operator<<(XML);
+
+    dout << "MultiCells Loaded" << std::endl;
+  }
+
+  void
+  GMultiCells::operator<<(const magnet::xml::Node& XML)
+  {
+    globName = XML.getAttribute("Name");
+    range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
+
+    _levels.clear();
+    for (magnet::xml::Node node = XML.fastGetNode("Level"); node.valid(); ++node)
+      addLevel(IDRange::getClass(node.getNode("IDRange"), Sim),
+	       node.getAttribute("NeighbourhoodRange").as<double>() * Sim->units.unitLength());
+  }
+
+  void
+  GMultiCells::addLevel(IDRange* levelRange, double neighbourhoodRange)
+  {
+    Level level;
+    level._range = neighbourhoodRange;
+    level._cells = shared_ptr<GCells>(new GCells(Sim, globName + "Level"));
+    level._cells->range = shared_ptr<IDRange>(levelRange);
+    level._cells->setConfigOutput(false);
+    level._cells->_sigNewNeighbour.connect<GMultiCells, &GMultiCells::forwardNewNeighbour>(this);
+    level._cells->_sigNewLocal.connect<GMultiCells, &GMultiCells::forwardNewLocal>(this);
+    _levels.push_back(level);
+  }
+
+  void
+  GMultiCells::initialise(size_t nID)
+  {
+    Global::initialise(nID);
+    reinitialise();
+  }
+
+  void
+  GMultiCells::reinitialise()
+  {
+    GNeighbourList::reinitialise();
+
+    if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+      M_throw() << "The MultiCells neighbour list \"" << globName << "\" does not support Lees-Edwards boundary conditions";
+
+    if (_levels.empty())
+      M_throw() << "The MultiCells neighbour list \"" << globName << "\" has no Levels";
+
+    //Sort the particles into their levels
+    const size_t unassigned = std::numeric_limits<size_t>::max();
+    _particleLevel.assign(Sim->N(), unassigned);
+    for (size_t l(0); l < _levels.size(); ++l)
+      for (const size_t& pid : *_levels[l]._cells->range)
+	{
+	  if (!range->isInRange(Sim->particles[pid]))
+	    M_throw() << "Particle " << pid << " is in Level " << l << " of the MultiCells neighbour list \""
+		      << globName << "\" but not in its IDRange";
+
+	  if (_particleLevel[pid] != unassigned)
+	    M_throw() << "Particle " << pid << " is in Levels " << _particleLevel[pid] << " and " << l
+		      << " of the MultiCells neighbour list \"" << globName << "\"";
+
+	  _particleLevel[pid] = l;
+	}
+
+    for (const size_t& pid : *range)
+      if (_particleLevel[pid] == unassigned)
+	M_throw() << "Particle " << pid << " is not in any Level of the MultiCells neighbour list \"" << globName << "\"";
+
+    //The interactions between the particles of two levels are only
+    //found up to the larger of the two NeighbourhoodRanges. The
+    //Interaction used for a pair is the first that covers it.
+    for (size_t l1(0); l1 < _levels.size(); ++l1)
+      for (size_t l2(l1); l2 < _levels.size(); ++l2)
+	{
+	  const double supported = getPad(l1, l2);
+	  for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+	    {
+	      const IDPairRange::PairCoverage coverage
+		= interaction->getRange()->getCoverage(*Sim, *_levels[l1]._cells->range, *_levels[l2]._cells->range);
+
+	      if (coverage == IDPairRange::NO_PAIRS) continue;
+
+	      if (interaction->maxIntDist() > supported)
+		M_throw() << "The Interaction \"" << interaction->getName() << "\" between Levels " << l1 << " and " << l2
+			  << " of the MultiCells neighbour list \"" << globName << "\" has a range of "
+			  << interaction->maxIntDist() / Sim->units.unitLength()
+			  << " but the largest NeighbourhoodRange of the Levels is only " << supported / Sim->units.unitLength();
+
+	      if (coverage == IDPairRange::ALL_PAIRS) break;
+	    }
+	}
+
+    for (size_t l(0); l < _levels.size(); ++l)
+      {
+	dout << "Level " << l << " NeighbourhoodRange " << _levels[l]._range / Sim->units.unitLength()
+	     << " Particles " << _levels[l]._cells->range->size() << std::endl;
+	_levels[l]._cells->setMaxInteractionRange(_levels[l]._range);
+	_levels[l]._cells->initialise(ID);
+      }
+
+    _sigReInitialise();
+  }
+
+  GlobalEvent
+  GMultiCells::getEvent(const Particle& part) const
+  { return _levels[_particleLevel[part.getID()]]._cells->getEvent(part); }
+
+  void
+  GMultiCells::runEvent(Particle& part, const double dt)
+  {
+    const size_t levelID = _particleLevel[part.getID()];
+    GCells& cells = *_levels[levelID]._cells;
+
+    const auto oldCoords = cells._ordering.toCoord(cells._cellData.getCellID(part.getID()));
+
+    //The level's own cells handle the event and the neighbours within
+    //the level
+    cells.runEvent(part, dt);
+
+    const auto newCoords = cells._ordering.toCoord(cells._cellData.getCellID(part.getID()));
+
+    //Find the new cell's position in the same periodic image as the
+    //old cell
+    const Vector oldOrigin = cells.calcPosition(oldCoords);
+    Vector newOrigin = oldOrigin;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	const long n = cells._ordering.getDimensions()[iDim];
+	long diff = long(newCoords[iDim]) - long(oldCoords[iDim]);
+	if (diff > 1) diff -= n;
+	if (diff < -1) diff += n;
+	newOrigin[iDim] += diff * cells._cellLatticeWidth[iDim];
+      }
+
+    //Signal the particles in the cells of the other levels which the
+    //new cell overlaps but the old cell did not
+    _newNeighbours.clear();
+    for (size_t l(0); l < _levels.size(); ++l)
+      {
+	if (l == levelID) continue;
+	CellRange oldLo, oldHi, newLo, newHi;
+	getOverlappingCells(_levels[l], oldOrigin, cells._cellDimension, getPad(l, levelID), oldLo, oldHi);
+	getOverlappingCells(_levels[l], newOrigin, cells._cellDimension, getPad(l, levelID), newLo, newHi);
+	getCellContents(_levels[l], newLo, newHi, _newNeighbours, &oldLo, &oldHi);
+      }
+
+    if (_newNeighbours.empty()) return;
+
+    for (const size_t& id : _newNeighbours)
+      _sigNewNeighbour(part, id);
+
+    Sim->ptrScheduler->sort(part);
+  }
+
+  void
+  GMultiCells::getOverlappingCells(const Level& level, const Vector& origin, const Vector& width, double pad,
+				   CellRange& lo, CellRange& hi) const
+  {
+    const GCells& cells = *level._cells;
+    //Inflate the padding slightly so that the relation is symmetric
+    //despite rounding
+    pad *= 1.0 + 10 * std::numeric_limits<double>::epsilon();
+
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	//The lowest corner of the cell at coordinate c is at
+	//c * w + base.
+	const double base = cells._cellOffset[iDim] - 0.5 * Sim->primaryCellSize[iDim];
+	const double w = cells._cellLatticeWidth[iDim];
+	lo[iDim] = std::ceil((origin[iDim] - pad - cells._cellDimension[iDim] - base) / w);
+	hi[iDim] = std::floor((origin[iDim] + width[iDim] + pad - base) / w);
+      }
+  }
+
+  void
+  GMultiCells::getCellContents(const Level& level, const CellRange& lo, const CellRange& hi,
+			       std::vector<size_t>& retlist, const CellRange* excludeLo,
+			       const CellRange* excludeHi) const
+  {
+    const GCells& cells = *level._cells;
+
+    //The wrapped coordinates of the cells in each dimension, and if
+    //they are inside the excluded range
+    std::array<std::vector<std::pair<size_t, bool> >, 3> coords;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	const long n = cells._ordering.getDimensions()[iDim];
+	const bool wholeDim = (hi[iDim] - lo[iDim] + 1 >= n);
+	const long start = wholeDim ? 0 : lo[iDim];
+	const long end = wholeDim ? n - 1 : hi[iDim];
+	for (long c(start); c <= end; ++c)
+	  {
+	    const size_t wrapped = ((c % n) + n) % n;
+	    bool excluded = false;
+	    if (excludeLo)
+	      excluded = ((*excludeHi)[iDim] - (*excludeLo)[iDim] + 1 >= n)
+		|| (((((long(wrapped) - (*excludeLo)[iDim]) % n) + n) % n) <= (*excludeHi)[iDim] - (*excludeLo)[iDim]);
+	    coords[iDim].push_back(std::make_pair(wrapped, excluded));
+	  }
+      }
+
+    for (const auto& x : coords[0])
+      for (const auto& y : coords[1])
+	for (const auto& z : coords[2])
+	  {
+	    if (x.second && y.second && z.second) continue;
+	    const auto& contents = cells._cellData.getCellContents(cells._ordering.toIndex(std::array<size_t, 3>{{x.first, y.first, z.first}}));
+	    retlist.insert(retlist.end(), contents.begin(), contents.end());
+	  }
+  }
+
+  void
+  GMultiCells::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const
+  {
+    const size_t levelID = _particleLevel[part.getID()];
+    const GCells& cells = *_levels[levelID]._cells;
+    cells.getParticleNeighbours(part, retlist);
+
+    const Vector origin = cells.calcPosition(cells._ordering.toCoord(cells._cellData.getCellID(part.getID())));
+    for (size_t l(0); l < _levels.size(); ++l)
+      {
+	if (l == levelID) continue;
+	CellRange lo, hi;
+	getOverlappingCells(_levels[l], origin, cells._cellDimension, getPad(l, levelID), lo, hi);
+	getCellContents(_levels[l], lo, hi, retlist);
+      }
+  }
+
+  void
+  GMultiCells::getParticleNeighbours(const Vector& pos, std::vector<size_t>& retlist) const
+  {
+    //The particle at this position could be in any level, so search
+    //with the largest range
+    double pad = 0;
+    for (const Level& level : _levels)
+      pad = std::max(pad, level._range);
+
+    for (const Level& level : _levels)
+      {
+	CellRange lo, hi;
+	getOverlappingCells(level, pos, Vector(0, 0, 0), pad, lo, hi);
+	getCellContents(level, lo, hi, retlist);
+      }
+  }
+
+  void
+  GMultiCells::getParticleLocals(const Particle& part, std::vector<size_t>& retlist) const
+  { _levels[_particleLevel[part.getID()]]._cells->getParticleLocals(part, retlist); }
+
+  double
+  GMultiCells::getMaxSupportedInteractionLength() const
+  {
+    double retval = HUGE_VAL;
+    for (const Level& level : _levels)
+      retval = std::min(retval, level._cells->getMaxSupportedInteractionLength());
+    return retval;
+  }
+
+  double
+  GMultiCells::getRebuildRange() const
+  {
+    //The levels grow in proportion, so the level with the least
+    //headroom sets the limit
+    double growth = HUGE_VAL;
+    for (const Level& level : _levels)
+      growth = std::min(growth, level._cells->getMaxSupportedInteractionLength() / level._range);
+    return _maxInteractionRange * growth;
+  }
+
+  void
+  GMultiCells::setMaxInteractionRange(double range)
+  {
+    if (_maxInteractionRange)
+      for (Level& level : _levels)
+	level._range *= range / _maxInteractionRange;
+
+    GNeighbourList::setMaxInteractionRange(range);
+  }
+
+  void
+  GMultiCells::outputXML(magnet::xml::XmlStream& XML) const
+  {
+    XML << magnet::xml::tag("Global")
+	<< magnet::xml::attr("Type") << "MultiCells"
+	<< magnet::xml::attr("Name") << globName
+	<< range;
+
+    for (const Level& level : _levels)
+      XML << magnet::xml::tag("Level")
+	  << magnet::xml::attr("NeighbourhoodRange") << level._range / Sim->units.unitLength()
+	  << level._cells->range
+	  << magnet::xml::endtag("Level");
+
+    XML << magnet::xml::endtag("Global");
+  }
+}
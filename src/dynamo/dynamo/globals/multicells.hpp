@@ -0,0 +1,153 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/globals/cells.hpp>
+#include <array>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A multi-level cell neighbour list for polydisperse
+      systems.
+
+    A single GCells list must size its cells for the longest
+    interaction in the system, so a few large particles in a bath of
+    small particles give the small particles enormous neighbourhoods.
+    This neighbour list instead sorts the particles into levels (size
+    classes), and each level has its own GCells grid sized for the
+    interactions of its particles.
+
+    Each level is specified by an IDRange and a NeighbourhoodRange,
+    which must be at least the longest interaction between a particle
+    of the level and any particle in a level with a smaller
+    NeighbourhoodRange. The list throws when it is initialised if
+    this is not the case.
+
+    Neighbours within a level are handled by that level's GCells. A
+    particle in a cell of one level is a neighbour of a particle in
+    another level if the first cell overlaps the second cell expanded
+    by the larger of the two NeighbourhoodRanges. This relation is
+    symmetric and only changes when one of the particles changes
+    cell, so each cell transition only signals the particles in the
+    other levels' cells that are newly overlapped.
+
+    \code
+    <Global Type="MultiCells" Name="SchedulerNBList">
+      <IDRange Type="All"/>
+      <Level NeighbourhoodRange="10">
+        <IDRange Type="Ranged" Start="0" End="99"/>
+      </Level>
+      <Level NeighbourhoodRange="1">
+        <IDRange Type="Ranged" Start="100" End="9999"/>
+      </Level>
+    </Global>
+    \endcode
+   */
+  class GMultiCells: public GNeighbourList
+  {
+  public:
+    GMultiCells(const magnet::xml::Node&, dynamo::Simulation*);
+    GMultiCells(dynamo::Simulation*, const std::string&);
+
+    virtual ~GMultiCells() {}
+
+    /*! \brief Adds a level for the particles in the range.
+
+      \param range The particles sorted into this level.
+      \param neighbourhoodRange The longest interaction between a
+      particle in this level and a particle in this or any level with
+      a smaller neighbourhood range.
+     */
+    void addLevel(IDRange* range, double neighbourhoodRange);
+
+    virtual GlobalEvent getEvent(const Particle &) const;
+
+    virtual void runEvent(Particle&, const double);
+
+    virtual void initialise(size_t);
+
+    virtual void reinitialise();
+
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
+
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const;
+
+    virtual void operator<<(const magnet::xml::Node&);
+
+    /*! \brief The longest interaction supported between any two
+        particles, which is the shortest range of the levels.
+     */
+    virtual double getMaxSupportedInteractionLength() const;
+
+    virtual double getRebuildRange() const;
+
+    /*! \brief Grows the NeighbourhoodRange of every level in
+        proportion to the change in the requested range (e.g., as the
+        particles are compressed).
+     */
+    virtual void setMaxInteractionRange(double range);
+
+  protected:
+    struct Level
+    {
+      shared_ptr<GCells> _cells;
+      double _range;
+    };
+
+    std::vector<Level> _levels;
+
+    //! The level of each particle.
+    std::vector<size_t> _particleLevel;
+
+    typedef std::array<long, 3> CellRange;
+
+    /*! \brief Calculates the (unwrapped) coordinates of the cells of
+        a level which overlap a box.
+
+      \param level The level to search.
+      \param origin The lowest corner of the box.
+      \param width The width of the box.
+      \param pad The distance to expand the box by.
+      \param lo The lowest cell coordinates.
+      \param hi The highest cell coordinates.
+     */
+    void getOverlappingCells(const Level& level, const Vector& origin, const Vector& width, double pad,
+			     CellRange& lo, CellRange& hi) const;
+
+    /*! \brief Adds the contents of the cells between lo and hi
+        (inclusive, periodically wrapped) to the list.
+
+      If an exclusion range is given, the cells inside it are
+      skipped.
+     */
+    void getCellContents(const Level& level, const CellRange& lo, const CellRange& hi,
+			 std::vector<size_t>& retlist, const CellRange* excludeLo = NULL,
+			 const CellRange* excludeHi = NULL) const;
+
+    //! The padding used between the cells of two levels.
+    double getPad(size_t level1, size_t level2) const
+    { return std::max(_levels[level1]._range, _levels[level2]._range); }
+
+    void forwardNewNeighbour(const Particle& part, const size_t& ID) { _sigNewNeighbour(part, ID); }
+    void forwardNewLocal(const Particle& part, const size_t& ID) { _sigNewLocal(part, ID); }
+
+    mutable std::vector<size_t> _newNeighbours;
+
+    virtual void outputXML(magnet::xml::XmlStream&) const;
+  };
+}
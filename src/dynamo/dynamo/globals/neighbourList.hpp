@@ -47,6 +47,39 @@ namespace dynamo {
     virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const = 0;
     virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const = 0;
 
+    /*! \brief Returns the IDs of the Locals which may generate
+        events for the particle before it next changes neighbours.
+
+      The default implementation returns every Local.
+     */
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>& retlist) const
+    {
+      for (size_t ID(0); ID < Sim->locals.size(); ++ID)
+	retlist.push_back(ID);
+    }
+
+    /*! \brief Splits the particles tracked by this neighbour list
+        into spatially compact domains.
+
+      This is used to distribute work over multiple threads such that
+      each thread mostly works on particles which are close together
+      (and thus share neighbours and cache lines). The default
+      implementation simply splits the IDRange of the neighbour list
+      into contiguous blocks.
+
+      \param domains The container to fill with the particle IDs of
+      each domain. Its size on entry sets the number of domains
+      requested.
+     */
+    virtual void getDomainDecomposition(std::vector<std::vector<size_t> >& domains) const
+    {
+      const size_t ndomains = domains.size();
+      if (!ndomains) return;
+      const size_t N = range->size();
+      for (size_t i(0); i < N; ++i)
+	domains[(i * ndomains) / N].push_back((*range)[i]);
+    }
+
     /*! \brief This returns the maximum interaction length this
       neighbourlist supports.
       
@@ -57,6 +90,15 @@ namespace dynamo {
     virtual double
     getMaxSupportedInteractionLength() const = 0;
 
+    /*! \brief The largest value of \ref getMaxInteractionRange()
+        this neighbourlist supports before it must be rebuilt.
+
+      For a neighbourlist which treats every particle alike, this is
+      just \ref getMaxSupportedInteractionLength().
+     */
+    virtual double getRebuildRange() const
+    { return getMaxSupportedInteractionLength(); }
+
     virtual void reinitialise()
     {
       if (!_maxInteractionRange)
@@ -72,7 +114,7 @@ namespace dynamo {
       
       \sa getMaxSupportedInteractionLength()
      */
-    void setMaxInteractionRange(double range)
+    virtual void setMaxInteractionRange(double range)
     {
       _maxInteractionRange = range;
       if (_initialised) reinitialise();
@@ -85,6 +127,7 @@ namespace dynamo {
     { return _maxInteractionRange; }
 
     mutable magnet::Signal<void(const Particle&, const size_t&)> _sigNewNeighbour;
+    mutable magnet::Signal<void(const Particle&, const size_t&)> _sigNewLocal;
     mutable magnet::Signal<void(const Particle&, const size_t&)> _sigCellChange;
     mutable magnet::Signal<void()> _sigReInitialise;
 
@@ -19,6 +19,7 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
+#include <dynamo/binaryconfig.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 
@@ -32,10 +33,12 @@ namespace dynamo {
 	_mapUninitialised = false;
 	clear();
 
+	std::vector<size_t> ids;
 	for (const auto& p1 : Sim->particles)
 	  {
-	    std::unique_ptr<IDRange> ids(Sim->ptrScheduler->getParticleNeighbours(p1));
-	    for (size_t ID2 : *ids)
+	    ids.clear();
+	    Sim->ptrScheduler->getParticleNeighbours(p1, ids);
+	    for (size_t ID2 : ids)
 	      if (ID2 != p1.getID())
 		{
 		  if (Sim->getInteraction(p1, Sim->particles[ID2]).get() == static_cast<const Interaction*>(this))
@@ -66,10 +69,39 @@ namespace dynamo {
       }
   }
 
+  void
+  ICapture::loadCaptureMap(const binary::Reader& file)
+  {
+    const binary::Reader::Block* block = file.find(binary::CAPTUREMAP, getName());
+    if (!block) return;
+
+    _mapUninitialised = false;
+    clear();
+    
+    for (const binary::CaptureRecord* entry = block->begin<binary::CaptureRecord>(); 
+	 entry != block->end<binary::CaptureRecord>(); ++entry)
+      Map::operator[](Map::key_type(entry->ID1, entry->ID2)) = entry->value;
+  }
+
+  void
+  ICapture::outputCaptureMap(binary::Writer& file) const
+  {
+    if (_mapUninitialised) return;
+
+    binary::CaptureRecord* entry = file.addBlock<binary::CaptureRecord>(binary::CAPTUREMAP, getName(), Map::size());
+    for (const Map::value_type& IDs : *this)
+      {
+	entry->ID1 = IDs.first.first;
+	entry->ID2 = IDs.first.second;
+	entry->value = IDs.second;
+	++entry;
+      }
+  }
+
   void 
   ICapture::outputCaptureMap(magnet::xml::XmlStream& XML) const 
   {
-    if (_mapUninitialised) return;
+    if (_mapUninitialised || !_xmlCaptureMap) return;
     XML << magnet::xml::tag("CaptureMap");
 
     for (const Map::value_type& IDs : *this)
@@ -23,9 +23,12 @@
 #ifdef DYNAMO_JUDY
 # include <magnet/containers/judy.hpp>
 #else
-# include <unordered_map>
+# include <magnet/containers/flat_hash_map.hpp>
+# include <functional>
 #endif
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace dynamo { 
   namespace detail { 
@@ -68,12 +71,20 @@ namespace std
 
 namespace dynamo {
   namespace detail {
-    namespace {
-      ::std::size_t
-      hash_combine(const ::std::size_t hash1, const ::std::size_t hash2)
-      {
-	return hash1 ^ (hash2 + 0x9e3779b9 + (hash1 << 6) + (hash1 >> 2));
-      }
+    /*! \brief The Zobrist key of a captured pair in a particular
+      state.
+
+      This is a pseudo-random 64 bit value for each pair and state
+      (generated by the splitmix64 finaliser, as a table of random
+      values for every possible pair would be far too large).
+    */
+    inline uint64_t
+    zobristKey(const PairKey& key, const size_t state)
+    {
+      uint64_t z = uint64_t(key) ^ (uint64_t(state) * 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
     }
     
     /*!\brief This is a container that stores a single size_t
@@ -81,49 +92,57 @@ namespace dynamo {
        
       To efficiently store the state of all possible particle
       pairings, a map is used and entries are only stored if the
-      state is non-zero. Although an unordered_map may be slightly
-      faster, a map is used to allow comparison of CaptureMaps and a
-      rapid hashing if CaptureMaps are to be used as an index of the
-      simulation state.
+      state is non-zero. Dense systems may hold tens of millions of
+      captured pairs, so the map is a flat open-addressing hash table
+      (magnet::containers::FlatHashMap) rather than a node based
+      container, unless libJudy is available.
        
       To facilitate the storage only if non-zero behaviour, the array
       access operator is overloaded to automatically return a size_t
       0 for any entry which is missing. It also returns a proxy which
       deletes entries when they are set to 0.
+
+      The map also maintains a Zobrist hash of its contents, which is
+      the XOR of the zobristKey() of every entry. This is independent
+      of the order of the entries and is updated in O(1) as entries
+      change, so the maps may be used to index the state of the
+      simulation without rehashing every entry. Only modify the map
+      through the array access operator or clear() to keep the hash
+      valid.
     */
 
 #ifdef DYNAMO_JUDY
     typedef magnet::containers::JudyMap<PairKey, size_t> CaptureMapContainer;
 #else
-    typedef std::unordered_map<PairKey, size_t> CaptureMapContainer;
+    //The empty key is the pair (2^32-1, 2^32-1), which cannot be
+    //stored as the IDs of a pair are never equal.
+    typedef magnet::containers::FlatHashMap<PairKey, size_t> CaptureMapContainer;
 #endif
     class CaptureMap: public CaptureMapContainer
     {
       typedef CaptureMapContainer Container;
     public:
+      CaptureMap(): _hash(0) {}
+
       /*!\brief This proxy is used to double check if an assignment of
 	zero is done, and delete the entry if it is. */
       struct EntryProxy {
       public:
-	EntryProxy(Container& container, const PairKey& key):
-	  _container(container), _key(key) {}
+	EntryProxy(CaptureMap& map, const PairKey& key):
+	  _map(map), _key(key) {}
 
 	operator const size_t() const {
-	  const auto it (_container.find(_key));
-	  return (it == _container.end()) ? 0 : (it->second);
+	  const auto it (_map.Container::find(_key));
+	  return (it == _map.Container::end()) ? 0 : (it->second);
 	}
 	
 	EntryProxy& operator=(size_t newval) {
-	  if (newval == 0)
-	    _container.erase(_key);
-	  else
-	    _container[_key] = newval;
-
+	  _map.set(_key, newval);
 	  return *this;
 	}
 	
       private:
-	Container& _container;
+	CaptureMap& _map;
 	const PairKey _key;
       };
       
@@ -133,26 +152,71 @@ namespace dynamo {
 	return EntryProxy(*this, key); 
       }
 
+      //! \brief Set the state of a pair, erasing the entry if it is 0.
+      void set(const PairKey& key, const size_t newval) {
+	const auto it (Container::find(key));
+	if (it != Container::end())
+	  {
+	    _hash ^= zobristKey(key, it->second);
+	    if (newval == 0)
+	      Container::erase(key);
+	    else
+	      it->second = newval;
+	  }
+	else if (newval != 0)
+	  Container::operator[](key) = newval;
+
+	if (newval != 0)
+	  _hash ^= zobristKey(key, newval);
+      }
+
+      void clear() {
+	Container::clear();
+	_hash = 0;
+      }
+
+      //! \brief The Zobrist hash of the entries of the map.
+      uint64_t hash() const { return _hash; }
+
       /*! \brief A simple const array access operator which returns 0
 	if the entry is missing. */
       size_t operator[](const PairKey& key) const {
 	Container::const_iterator it = Container::find(key);
 	return (it == Container::end()) ? 0 : (it->second);
       }
+
+    private:
+      uint64_t _hash;
     };
 
+    /*! \brief A canonical copy of the entries of a CaptureMap.
+
+      The entries are sorted by their pair, so equal maps always give
+      equal keys (the iteration order of the CaptureMap depends on its
+      history). The Zobrist hash of the map is kept alongside.
+     */
     struct CaptureMapKey: public std::vector<CaptureMap::value_type>
     {
       typedef std::vector<CaptureMap::value_type> Container;
       CaptureMapKey(const CaptureMap& map):
-      Container(map.begin(), map.end()) {}
+	Container(map.begin(), map.end()),
+	_hash(map.hash())
+      {
+	std::sort(Container::begin(), Container::end(),
+		  [](const value_type& a, const value_type& b) { return uint64_t(a.first) < uint64_t(b.first); });
+      }
+
+      std::size_t hash() const { return _hash; }
 
-      std::size_t hash() const {
-	std::size_t hash(0);
-	for (const Container::value_type& val : *this)
-	  hash = hash_combine(hash, hash_combine(size_t(val.first), size_t(val.second)));
-	return hash;
+      //! \brief Test if a pair is in the key, in O(log N) time.
+      bool contains(const PairKey& key) const {
+	auto it = std::lower_bound(Container::begin(), Container::end(), key,
+				   [](const value_type& a, const PairKey& b) { return uint64_t(a.first) < uint64_t(b); });
+	return (it != Container::end()) && (uint64_t(it->first) == uint64_t(key));
       }
+
+    private:
+      uint64_t _hash;
     };
 
     /*! \brief A functor to allow the storage of CaptureMapKey types
@@ -165,6 +229,7 @@ namespace dynamo {
 }
 
 namespace dynamo {
+  namespace binary { class Reader; class Writer; }
 
   /*! \brief A general interface for \ref Interaction classes with
     states for the particle pairs.
@@ -180,7 +245,7 @@ namespace dynamo {
     typedef detail::CaptureMap Map;
 
   public:
-    ICapture(dynamo::Simulation* sim, IDPairRange* range): Interaction(sim, range), _mapUninitialised(true) {}
+    ICapture(dynamo::Simulation* sim, IDPairRange* range): Interaction(sim, range), _mapUninitialised(true), _xmlCaptureMap(true) {}
 
     //! \brief A test if two particles are captured
     size_t isCaptured(const Particle& p1, const Particle& p2) const {
@@ -200,10 +265,29 @@ namespace dynamo {
 
     void initCaptureMap();
 
+    /*! \brief Load the capture map from a binary configuration
+        file, if it was stored there.
+     */
+    void loadCaptureMap(const binary::Reader&);
+
+    /*! \brief Store the capture map in a binary configuration
+        file.
+     */
+    void outputCaptureMap(binary::Writer&) const;
+
+    /*! \brief Controls if the capture map is written in the XML
+        output.
+
+	This is disabled while a binary configuration file is written,
+	as the map is then stored in its own block.
+     */
+    void setXMLCaptureMap(bool enable) { _xmlCaptureMap = enable; }
+
     virtual size_t captureTest(const Particle&, const Particle&) const = 0;
 
   protected:  
     bool _mapUninitialised;
+    bool _xmlCaptureMap;
 
     void loadCaptureMap(const magnet::xml::Node&);
 
@@ -104,6 +104,21 @@ namespace dynamo {
     return IntEvent(p1,p2,HUGE_VAL, NONE, *this);  
   }
 
+  void
+  IHardSphere::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    _batchD.resize(ids.size());
+    for (size_t i(0); i < ids.size(); ++i)
+      _batchD[i] = _diameter->getProperty(p1.getID(), ids[i]);
+
+    Sim->dynamics->SphereSphereInRoot(p1, ids, _batchD, _batchDt);
+
+    events.clear();
+    for (size_t i(0); i < ids.size(); ++i)
+      if (_batchDt[i] != HUGE_VAL)
+	events.push_back(IntEvent(p1, Sim->particles[ids[i]], _batchDt[i], CORE, *this));
+  }
+
   PairEventData
   IHardSphere::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -70,7 +70,9 @@ namespace dynamo {
     virtual void rescaleLengths(double) {}
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
- 
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
+
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
    
     virtual void outputXML(magnet::xml::XmlStream&) const;
@@ -83,5 +85,8 @@ namespace dynamo {
     shared_ptr<Property> _diameter;
     shared_ptr<Property> _e;
     shared_ptr<Property> _et;
+
+    //! \brief Storage for the batched event calculations.
+    mutable std::vector<double> _batchD, _batchDt;
   };
 }
@@ -40,6 +40,18 @@ namespace dynamo {
 			 Sim->particles[coll.getParticle2ID()]); 
   }
 
+  void
+  Interaction::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    events.clear();
+    for (const size_t id : ids)
+      {
+	const IntEvent event = getEvent(p1, Sim->particles[id]);
+	if (event.getType() != NONE)
+	  events.push_back(event);
+      }
+  }
+
   magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, 
 				     const Interaction& g)
   {
@@ -22,6 +22,7 @@
 #include <string>
 #include <limits>
 #include <array>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -73,6 +74,18 @@ namespace dynamo {
      */
     virtual IntEvent getEvent(const Particle &, const Particle &) const = 0;
 
+    /*! \brief Calculate the events between a particle and a list of
+        other particles.
+
+      This allows the Scheduler to test a particle against all of its
+      neighbours which use this Interaction in one call, so that the
+      batched tests of the Dynamics may be used. All particles must
+      be up to date. Only events which will occur (i.e., are not of
+      type NONE) are stored in events, which is cleared first. The
+      default implementation calls getEvent for each pair.
+     */
+    virtual void getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const;
+
     /*! \brief Run the dynamics of an event which is occuring now.
      */
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&) = 0;
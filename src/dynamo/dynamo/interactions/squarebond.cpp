@@ -117,9 +117,9 @@ namespace dynamo {
   ISquareBond::validateState(bool textoutput, size_t max_reports) const
   {
     size_t retval(0);
-    for (std::vector<Particle>::const_iterator iPtr = Sim->particles.begin();
+    for (ParticleList::const_iterator iPtr = Sim->particles.begin();
 	 iPtr != Sim->particles.end(); ++iPtr)
-      for (std::vector<Particle>::const_iterator jPtr = iPtr + 1;
+      for (ParticleList::const_iterator jPtr = iPtr + 1;
 	   jPtr != Sim->particles.end(); ++jPtr)
 	{
 	  const Particle& p1 = *iPtr;
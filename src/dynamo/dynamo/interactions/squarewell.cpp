@@ -142,6 +142,56 @@ namespace dynamo {
     return retval;
   }
 
+  void
+  ISquareWell::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    //Every pair is tested for entering the core (if captured) or the
+    //well (if not), but only the captured pairs may leave the well.
+    _batchInD.resize(ids.size());
+    _batchOutIDs.clear();
+    _batchOutD.clear();
+    for (size_t i(0); i < ids.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[ids[i]];
+	const double d = _diameter->getProperty(p1, p2);
+	const double l = _lambda->getProperty(p1, p2);
+
+	if (isCaptured(p1, p2))
+	  {
+	    _batchInD[i] = d;
+	    _batchOutIDs.push_back(ids[i]);
+	    _batchOutD.push_back(l * d);
+	  }
+	else
+	  _batchInD[i] = l * d;
+      }
+
+    Sim->dynamics->SphereSphereInRoot(p1, ids, _batchInD, _batchInDt);
+    Sim->dynamics->SphereSphereOutRoot(p1, _batchOutIDs, _batchOutD, _batchOutDt);
+
+    events.clear();
+    for (size_t i(0), j(0); i < ids.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[ids[i]];
+	IntEvent retval(p1, p2, HUGE_VAL, NONE, *this);
+	
+	if ((j < _batchOutIDs.size()) && (_batchOutIDs[j] == ids[i]))
+	  {
+	    if (_batchInDt[i] != HUGE_VAL)
+	      retval = IntEvent(p1, p2, _batchInDt[i], CORE, *this);
+	    
+	    if (retval.getdt() > _batchOutDt[j])
+	      retval = IntEvent(p1, p2, _batchOutDt[j], STEP_OUT, *this);
+	    ++j;
+	  }
+	else if (_batchInDt[i] != HUGE_VAL)
+	  retval = IntEvent(p1, p2, _batchInDt[i], STEP_IN, *this);
+
+	if (retval.getType() != NONE)
+	  events.push_back(retval);
+      }
+  }
+
   PairEventData
   ISquareWell::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -49,6 +49,8 @@ namespace dynamo {
     virtual void initialise(size_t);
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
   
@@ -66,5 +68,9 @@ namespace dynamo {
     shared_ptr<Property> _lambda;
     shared_ptr<Property> _wellDepth;
     shared_ptr<Property> _e;
+
+    //! \brief Storage for the batched event calculations.
+    mutable std::vector<size_t> _batchOutIDs;
+    mutable std::vector<double> _batchInD, _batchInDt, _batchOutD, _batchOutDt;
   };
 }
@@ -153,6 +153,62 @@ namespace dynamo {
     return retval;
   }
 
+  void
+  IStepped::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    //Collect the pairs which have an inner and/or outer step to test
+    _batchInIDs.clear();
+    _batchInD.clear();
+    _batchOutIDs.clear();
+    _batchOutD.clear();
+    for (const size_t id : ids)
+      {
+	const Particle& p2 = Sim->particles[id];
+	const size_t current_step_ID = ICapture::operator[](ICapture::key_type(p1, p2));
+	const std::pair<double, double> step_bounds = _potential->getStepBounds(current_step_ID);
+	const double length_scale = _lengthScale->getProperty(p1, p2);
+
+	if (step_bounds.first != 0)
+	  {
+	    _batchInIDs.push_back(id);
+	    _batchInD.push_back(step_bounds.first * length_scale);
+	  }
+
+	if (!std::isinf(step_bounds.second))
+	  {
+	    _batchOutIDs.push_back(id);
+	    _batchOutD.push_back(step_bounds.second * length_scale);
+	  }
+      }
+
+    Sim->dynamics->SphereSphereInRoot(p1, _batchInIDs, _batchInD, _batchInDt);
+    Sim->dynamics->SphereSphereOutRoot(p1, _batchOutIDs, _batchOutD, _batchOutDt);
+
+    events.clear();
+    for (size_t i(0), j(0), k(0); i < ids.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[ids[i]];
+	IntEvent retval(p1, p2, HUGE_VAL, NONE, *this);
+
+	if ((j < _batchInIDs.size()) && (_batchInIDs[j] == ids[i]))
+	  {
+	    if (_batchInDt[j] != HUGE_VAL)
+	      retval = IntEvent(p1, p2, _batchInDt[j], STEP_IN, *this);
+	    ++j;
+	  }
+
+	if ((k < _batchOutIDs.size()) && (_batchOutIDs[k] == ids[i]))
+	  {
+	    if (retval.getdt() > _batchOutDt[k])
+	      retval = IntEvent(p1, p2, _batchOutDt[k], STEP_OUT, *this);
+	    ++k;
+	  }
+
+	if (retval.getType() != NONE)
+	  events.push_back(retval);
+      }
+  }
+
   PairEventData
   IStepped::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -50,6 +50,8 @@ namespace dynamo {
     virtual void initialise(size_t);
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
   
@@ -77,5 +79,9 @@ namespace dynamo {
       double rdotv_sum;
     };
     std::map<std::pair<size_t, EEventType>, EdgeData> _edgedata;
+
+    //! \brief Storage for the batched event calculations.
+    mutable std::vector<size_t> _batchInIDs, _batchOutIDs;
+    mutable std::vector<double> _batchInD, _batchInDt, _batchOutD, _batchOutDt;
   };
 }
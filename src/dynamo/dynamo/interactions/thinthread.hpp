@@ -34,6 +34,10 @@ namespace dynamo {
     virtual size_t captureTest(const Particle&, const Particle&) const { return false; }
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    //The batched ISquareWell events do not include the bridges
+    virtual void getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+    { Interaction::getEvents(p1, ids, events); }
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
   
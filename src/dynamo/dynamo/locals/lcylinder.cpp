@@ -46,6 +46,27 @@ namespace dynamo {
     return LocalEvent(part, Sim->dynamics->getCylinderWallCollision(part, vPosition, vAxis, colldist), WALL, *this);
   }
 
+  bool
+  LCylinder::isInCell(const Vector& origin, const Vector& width) const
+  {
+    //The distance to the axis is convex, so its maximum over the
+    //cell is at one of the corners. Events only occur when a
+    //particle is at least _cyl_radius from the axis.
+    for (size_t corner(0); corner < (1u << NDIM); ++corner)
+      {
+	Vector pos = origin - vPosition;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  if (corner & (1u << iDim))
+	    pos[iDim] += width[iDim];
+
+	pos -= (pos | vAxis) * vAxis;
+	if (pos.nrm() >= _cyl_radius)
+	  return true;
+      }
+
+    return false;
+  }
+
   void
   LCylinder::runEvent(Particle& part, const LocalEvent& iEvent) const
   {
@@ -78,6 +78,24 @@ namespace dynamo {
 
     virtual void outputData(magnet::xml::XmlStream&) const {}
 
+    /*! \brief Test if this Local may generate events for particles
+        inside an axis-aligned box.
+
+      This is used by the neighbour lists to only test a particle
+      against the Locals near it. The test may be conservative
+      (returning true for a box where no events can occur), and the
+      default implementation always returns true so that the Local is
+      tested against every particle.
+
+      The test must also be true for any box which contains a box
+      it is true for, as the neighbour lists skip whole blocks of
+      cells when it is false for the block.
+
+      \param origin The lowest corner of the box.
+      \param width The width of the box in each dimension.
+     */
+    virtual bool isInCell(const Vector& origin, const Vector& width) const { return true; }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
 
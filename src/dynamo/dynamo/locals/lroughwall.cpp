@@ -66,6 +66,10 @@ namespace dynamo {
     return LocalEvent(part, Sim->dynamics->getPlaneEvent(part, vPosition, vNorm, r), WALL, *this);
   }
 
+  bool
+  LRoughWall::isInCell(const Vector& origin, const Vector& width) const
+  { return magnet::overlap::cube_plane(origin, width, vPosition, vNorm, r); }
+
   void
   LRoughWall::runEvent(Particle& part, const LocalEvent& iEvent) const
   {
@@ -38,6 +38,8 @@ namespace dynamo {
 
     virtual bool validateState(const Particle& part, bool textoutput = true) const;
 
+    virtual bool isInCell(const Vector& origin, const Vector& width) const;
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
@@ -45,6 +45,10 @@ namespace dynamo {
     return LocalEvent(part, Sim->dynamics->getPlaneEvent(part, vPosition, vNorm, colldist), WALL, *this);
   }
 
+  bool
+  LWall::isInCell(const Vector& origin, const Vector& width) const
+  { return magnet::overlap::cube_plane(origin, width, vPosition, vNorm, 0.5 * _diameter->getMaxValue()); }
+
   void
   LWall::runEvent(Particle& part, const LocalEvent& iEvent) const
   {
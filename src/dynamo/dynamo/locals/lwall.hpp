@@ -50,6 +50,8 @@ namespace dynamo {
 
     virtual bool validateState(const Particle& part, bool textoutput = true) const;
 
+    virtual bool isInCell(const Vector& origin, const Vector& width) const;
+
 #ifdef DYNAMO_visualizer
     virtual shared_ptr<coil::RenderObj> getCoilRenderObj() const;
     virtual void updateRenderData() const;
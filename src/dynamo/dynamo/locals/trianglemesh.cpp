@@ -16,13 +16,16 @@
 */
 
 #include <dynamo/locals/trianglemesh.hpp>
-#include <dynamo/BC/BC.hpp>
+#include <dynamo/BC/LEBC.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/locals/localEvent.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 
 
 namespace dynamo {
@@ -30,6 +33,207 @@ namespace dynamo {
     Local(tmp, "LocalWall")
   { operator<<(XML); }
 
+  namespace {
+    //! Meshes with fewer triangles than this are tested brute force.
+    const size_t bvhMinTriangles = 16;
+    //! The maximum number of triangles in a BVH leaf node.
+    const size_t bvhLeafSize = 4;
+    /*! The size of the traversal stack, which holds at most one
+        entry per level of the BVH (plus the root).
+     */
+    const size_t bvhStackSize = 64;
+
+    float roundDown(double val)
+    {
+      float retval = val;
+      return (retval > val) ? std::nextafter(retval, -HUGE_VALF) : retval;
+    }
+
+    float roundUp(double val)
+    {
+      float retval = val;
+      return (retval < val) ? std::nextafter(retval, HUGE_VALF) : retval;
+    }
+  }
+
+  void
+  LTriangleMesh::initialise(size_t nID)
+  {
+    Local::initialise(nID);
+
+    buildBVH();
+
+    //The boxes must be smaller than half the system for the minimum
+    //image convention to hold in Dynamics::getSquareCellCollision2
+    _horizonWidth = _diameter->getMaxValue();
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      _horizonWidth = std::min(_horizonWidth, 0.2 * Sim->primaryCellSize[iDim]);
+
+    _horizonCentres.assign(Sim->N(), Vector(HUGE_VAL, HUGE_VAL, HUGE_VAL));
+  }
+
+  void
+  LTriangleMesh::buildBVH()
+  {
+    _bvhNodes.clear();
+    _bvhTriangles.clear();
+
+    //The periodic images of the triangles move under Lees-Edwards
+    //boundary conditions, so every triangle is tested
+    if ((_elements.size() < bvhMinTriangles) || std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+      return;
+
+    std::vector<Vector> centroids;
+    centroids.reserve(_elements.size());
+    for (const TriangleElements& elem : _elements)
+      centroids.push_back((_vertices[std::get<0>(elem)] + _vertices[std::get<1>(elem)] + _vertices[std::get<2>(elem)]) / 3);
+
+    _bvhTriangles.resize(_elements.size());
+    for (size_t id(0); id < _elements.size(); ++id)
+      _bvhTriangles[id] = id;
+
+    _bvhNodes.reserve(2 * _elements.size() / bvhLeafSize + 1);
+    buildBVHNode(0, _elements.size(), centroids, 0);
+
+    dout << "Built a BVH of " << _bvhNodes.size() << " nodes for the " << _elements.size() << " triangles of \"" << localName << "\"" << std::endl;
+  }
+
+  uint32_t
+  LTriangleMesh::buildBVHNode(size_t start, size_t end, const std::vector<Vector>& centroids, size_t depth)
+  {
+    //The median splits keep the depth logarithmic in the number of
+    //triangles, so this is only reached by meshes far larger than
+    //the 32 bit indices allow
+    if (depth + 1 >= bvhStackSize)
+      M_throw() << "The BVH of \"" << localName << "\" is deeper than the traversal stack";
+
+    const uint32_t nodeID = _bvhNodes.size();
+    _bvhNodes.push_back(BVHNode());
+
+    Vector min(HUGE_VAL, HUGE_VAL, HUGE_VAL), max(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+    Vector cmin = min, cmax = max;
+    for (size_t i(start); i < end; ++i)
+      {
+	const TriangleElements& elem = _elements[_bvhTriangles[i]];
+	for (const size_t vertex : {std::get<0>(elem), std::get<1>(elem), std::get<2>(elem)})
+	  {
+	    min = magnet::math::elementwiseMin(min, _vertices[vertex]);
+	    max = magnet::math::elementwiseMax(max, _vertices[vertex]);
+	  }
+	cmin = magnet::math::elementwiseMin(cmin, centroids[_bvhTriangles[i]]);
+	cmax = magnet::math::elementwiseMax(cmax, centroids[_bvhTriangles[i]]);
+      }
+
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	_bvhNodes[nodeID]._min[iDim] = roundDown(min[iDim]);
+	_bvhNodes[nodeID]._max[iDim] = roundUp(max[iDim]);
+      }
+
+    if (end - start <= bvhLeafSize)
+      {
+	_bvhNodes[nodeID]._offset = start;
+	_bvhNodes[nodeID]._count = end - start;
+	return nodeID;
+      }
+
+    //Split at the median centroid along the longest axis of the
+    //centroids' bounds
+    size_t axis = 0;
+    for (size_t iDim(1); iDim < NDIM; ++iDim)
+      if (cmax[iDim] - cmin[iDim] > cmax[axis] - cmin[axis])
+	axis = iDim;
+
+    const size_t mid = (start + end) / 2;
+    std::nth_element(_bvhTriangles.begin() + start, _bvhTriangles.begin() + mid, _bvhTriangles.begin() + end,
+		     [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    buildBVHNode(start, mid, centroids, depth + 1);
+    const uint32_t secondChild = buildBVHNode(mid, end, centroids, depth + 1);
+    _bvhNodes[nodeID]._offset = secondChild;
+    _bvhNodes[nodeID]._count = 0;
+    return nodeID;
+  }
+
+  template<class F>
+  bool
+  LTriangleMesh::forEachTriangle(const Vector& min, const Vector& max, F func) const
+  {
+    //The depth of the tree is checked against the stack size when
+    //it is built
+    uint32_t stack[bvhStackSize];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+      {
+	const BVHNode& node = _bvhNodes[stack[--stackSize]];
+
+	bool overlap = true;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  overlap &= (node._min[iDim] <= max[iDim]) && (node._max[iDim] >= min[iDim]);
+
+	if (!overlap) continue;
+
+	if (node._count)
+	  {
+	    for (size_t i(node._offset); i < node._offset + node._count; ++i)
+	      if (func(size_t(_bvhTriangles[i])))
+		return true;
+	  }
+	else
+	  {
+	    stack[stackSize++] = node._offset;
+	    stack[stackSize++] = (&node - &_bvhNodes[0]) + 1;
+	  }
+      }
+
+    return false;
+  }
+
+  void
+  LTriangleMesh::getNearbyTriangles(Vector min, Vector max, std::vector<size_t>& triangles) const
+  {
+    triangles.clear();
+
+    //Move the box into the primary image
+    Vector centre = 0.5 * (min + max);
+    Vector shift = centre;
+    Sim->BCs->applyBC(shift);
+    shift -= centre;
+    min += shift;
+    max += shift;
+
+    //Search the periodic images of the box which overlap the
+    //primary image. This is conservative as the dimension may not be
+    //periodic.
+    std::array<double, NDIM> shifts[2];
+    std::array<size_t, NDIM> nShifts;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	nShifts[iDim] = 1;
+	shifts[0][iDim] = 0;
+	if (min[iDim] < -0.5 * Sim->primaryCellSize[iDim])
+	  shifts[nShifts[iDim]++][iDim] = Sim->primaryCellSize[iDim];
+	else if (max[iDim] > 0.5 * Sim->primaryCellSize[iDim])
+	  shifts[nShifts[iDim]++][iDim] = -Sim->primaryCellSize[iDim];
+      }
+
+    for (size_t i(0); i < nShifts[0]; ++i)
+      for (size_t j(0); j < nShifts[1]; ++j)
+	for (size_t k(0); k < nShifts[2]; ++k)
+	  {
+	    const Vector image(shifts[i][0], shifts[j][1], shifts[k][2]);
+	    forEachTriangle(min + image, max + image, [&](size_t id) { triangles.push_back(id); return false; });
+	  }
+
+    if (nShifts[0] * nShifts[1] * nShifts[2] > 1)
+      {
+	std::sort(triangles.begin(), triangles.end());
+	triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+      }
+  }
+
   LocalEvent 
   LTriangleMesh::getEvent(const Particle& part) const
   {
@@ -43,7 +247,44 @@ namespace dynamo {
 
     std::pair<double, size_t> tmin(HUGE_VAL, 0); //Default to no collision
 
-    for (size_t id(0); id < _elements.size(); ++id)
+    if (_bvhNodes.empty())
+      {
+	for (size_t id(0); id < _elements.size(); ++id)
+	  {
+	    std::pair<double, size_t> t 
+	      = Sim->dynamics->getSphereTriangleEvent(part,
+						      _vertices[std::get<0>(_elements[id])],
+						      _vertices[std::get<1>(_elements[id])],
+						      _vertices[std::get<2>(_elements[id])],
+						      diam);
+	    if (t < tmin) { tmin = t; triangleid = id; }
+	  }
+
+	return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
+      }
+
+    //Until the particle leaves its box, it can only collide with the
+    //triangles near the box
+    if (part.getID() >= _horizonCentres.size())
+      _horizonCentres.resize(part.getID() + 1, Vector(HUGE_VAL, HUGE_VAL, HUGE_VAL));
+
+    Vector& centre = _horizonCentres[part.getID()];
+    Vector rij = part.getPosition() - centre;
+    Sim->BCs->applyBC(rij);
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      if (!(std::abs(rij[iDim]) <= _horizonWidth * (1 + 1e-8)))
+	{
+	  centre = part.getPosition();
+	  break;
+	}
+
+    const Vector halfWidth(_horizonWidth, _horizonWidth, _horizonWidth);
+    const double horizon = Sim->dynamics->getSquareCellCollision2(part, centre - halfWidth, 2 * halfWidth);
+
+    const Vector searchWidth = halfWidth + Vector(diam, diam, diam);
+    getNearbyTriangles(centre - searchWidth, centre + searchWidth, _candidates);
+
+    for (const size_t id : _candidates)
       {
 	std::pair<double, size_t> t 
 	  = Sim->dynamics->getSphereTriangleEvent(part,
@@ -54,12 +295,54 @@ namespace dynamo {
 	if (t < tmin) { tmin = t; triangleid = id; }
       }
 
-    return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
+    if (tmin.first < horizon)
+      return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
+
+    return LocalEvent(part, horizon, VIRTUAL, *this);
+  }
+
+  bool
+  LTriangleMesh::isInCell(const Vector& origin, const Vector& width) const
+  {
+    //Test the bounding box of each triangle, expanded by the largest
+    //particle radius, against the cell
+    const double diam = 0.5 * _diameter->getMaxValue();
+
+    if (!_bvhNodes.empty())
+      return forEachTriangle(origin - Vector(diam, diam, diam), origin + width + Vector(diam, diam, diam),
+			     [](size_t) { return true; });
+
+    for (const TriangleElements& elem : _elements)
+      {
+	const Vector& A(_vertices[std::get<0>(elem)]);
+	const Vector& B(_vertices[std::get<1>(elem)]);
+	const Vector& C(_vertices[std::get<2>(elem)]);
+
+	bool overlap = true;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  overlap &= (std::min(A[iDim], std::min(B[iDim], C[iDim])) - diam <= origin[iDim] + width[iDim])
+	    && (std::max(A[iDim], std::max(B[iDim], C[iDim])) + diam >= origin[iDim]);
+
+	if (overlap) return true;
+      }
+
+    return false;
   }
 
   void
   LTriangleMesh::runEvent(Particle& part, const LocalEvent& iEvent) const
   { 
+    if (iEvent.getType() == VIRTUAL)
+      {
+	//The particle has reached the edge of its box, move the box
+	//and find the next event
+	Sim->dynamics->updateParticle(part);
+	_horizonCentres[part.getID()] = part.getPosition();
+	Sim->ptrScheduler->addLocalEvent(part, ID);
+	Sim->ptrScheduler->sort(part);
+	return;
+      }
+
     ++Sim->eventCount;
   
     const size_t triangleID = iEvent.getExtraData() / Dynamics::T_COUNT;
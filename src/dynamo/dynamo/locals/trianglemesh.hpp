@@ -19,6 +19,7 @@
 #include <dynamo/locals/local.hpp>
 #include <dynamo/coilRenderObj.hpp>
 #include <dynamo/simulation.hpp>
+#include <cstdint>
 #include <tuple>
 #include <vector>
 
@@ -41,6 +42,8 @@ namespace dynamo {
 
     virtual ~LTriangleMesh() {}
 
+    virtual void initialise(size_t nID);
+
     virtual LocalEvent getEvent(const Particle&) const;
 
     virtual void runEvent(Particle&, const LocalEvent&) const;
@@ -49,6 +52,8 @@ namespace dynamo {
 
     virtual bool validateState(const Particle& part, bool textoutput = true) const { return false; }
 
+    virtual bool isInCell(const Vector& origin, const Vector& width) const;
+
 #ifdef DYNAMO_visualizer
     virtual shared_ptr<coil::RenderObj> getCoilRenderObj() const;
     virtual void updateRenderData() const {}
@@ -68,5 +73,54 @@ namespace dynamo {
 
     shared_ptr<Property> _e;
     shared_ptr<Property> _diameter;
+
+    /*! \brief A node of the bounding volume hierarchy (BVH) of the
+        triangles.
+
+      The bounds are stored in single precision, rounded outwards so
+      that they always contain the triangles. The first child of an
+      interior node directly follows it in _bvhNodes.
+     */
+    struct BVHNode
+    {
+      float _min[3];
+      float _max[3];
+      //! For leaf nodes, the offset of the first triangle in
+      //! _bvhTriangles, otherwise the index of the second child.
+      uint32_t _offset;
+      //! The number of triangles in a leaf node, or zero for
+      //! interior nodes.
+      uint32_t _count;
+    };
+
+    std::vector<BVHNode> _bvhNodes;
+    std::vector<uint32_t> _bvhTriangles;
+
+    void buildBVH();
+    uint32_t buildBVHNode(size_t start, size_t end, const std::vector<Vector>& centroids, size_t depth);
+
+    /*! \brief Calls func(triangleID) for every triangle whose
+        bounding box overlaps the box [min, max], stopping early (and
+        returning true) if func returns true.
+     */
+    template<class F> bool forEachTriangle(const Vector& min, const Vector& max, F func) const;
+
+    /*! \brief Collects the triangles which may be hit by a sphere
+        whose centre is inside the box [min, max], including the
+        periodic images of the triangles.
+     */
+    void getNearbyTriangles(Vector min, Vector max, std::vector<size_t>& triangles) const;
+
+    /*! \brief The centre of the box each particle is confined to
+        while its events are calculated using the BVH.
+
+      A particle is only tested against the triangles near the box,
+      and a VIRTUAL event is scheduled for when it leaves the box. The
+      box is moved when this event is executed.
+     */
+    mutable std::vector<Vector> _horizonCentres;
+    //! The half width of the boxes in _horizonCentres.
+    double _horizonWidth;
+    mutable std::vector<size_t> _candidates;
   };
 }
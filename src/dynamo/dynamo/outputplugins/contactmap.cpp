@@ -57,7 +57,14 @@ namespace dynamo {
     if (!_interaction)
       M_throw() << "Could not cast \"" << _interaction_name << "\" to an ICapture type to build the contact map";
     
-    _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->calcInternalEnergy(), _next_map_id++))).first;
+    _current_map = insertCurrentMap(Sim->calcInternalEnergy());
+  }
+
+  OPContactMap::CollectedMapType::iterator
+  OPContactMap::insertCurrentMap(double energy)
+  {
+    const detail::CaptureMapKey key(*_interaction);
+    return _collected_maps.insert(CollectedMapType::value_type(key.hash(), MapData(key, energy, _next_map_id++))).first;
   }
 
   void OPContactMap::stream(double dt) { _weight += dt; }
@@ -96,10 +103,14 @@ namespace dynamo {
     size_t oldMapID(_current_map->second._id);
     
     //Try and find the current map in the collected maps
-    _current_map = _collected_maps.find(*_interaction);
+    _current_map = _collected_maps.find(_interaction->hash());
     if (_current_map == _collected_maps.end())
       //Insert the new map
-      _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU(), _next_map_id++))).first;
+      _current_map = insertCurrentMap(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU());
+#ifdef DYNAMO_DEBUG
+    else if (!(_current_map->second._map == detail::CaptureMapKey(*_interaction)))
+      M_throw() << "Zobrist hash collision between two contact maps";
+#endif
     
     //Add the link	    
     if (addLink)
@@ -156,7 +167,7 @@ namespace dynamo {
 	    << magnet::xml::attr("Energy") << entry.second._energy / Sim->units.unitEnergy()
 	    << magnet::xml::attr("Weight") << entry.second._weight / _total_weight;
 	
-	for (const ICapture::value_type& ids : entry.first)
+	for (const ICapture::value_type& ids : entry.second._map)
 	  XML << magnet::xml::tag("Contact")
 	      << magnet::xml::attr("ID1") << ids.first.first
 	      << magnet::xml::attr("ID2") << ids.first.second
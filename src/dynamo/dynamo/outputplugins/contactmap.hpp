@@ -66,24 +66,31 @@ namespace dynamo {
 
     struct MapData
     {
-      MapData(double energy=0, size_t id = 0): _weight(0), _energy(energy), _id(id) {}
+      MapData(const detail::CaptureMapKey& map, double energy, size_t id): 
+	_map(map), _weight(0), _energy(energy), _id(id) {}
+      detail::CaptureMapKey _map;
       double _weight;
       double _energy;
       size_t _id;
     };
 
-    typedef std::unordered_map<detail::CaptureMapKey, MapData,  detail::CaptureMapKeyHash> CollectedMapType;
+    typedef std::unordered_map<uint64_t, MapData> CollectedMapType;
     typedef std::unordered_map<std::pair<size_t, size_t>, size_t, detail::OPContactMapPairHash> LinksMapType;
     /*! \brief A hash table storing the histogram of the contact maps.
       
-      The key of this map is a sorted list of the captured pairs in
-      the system. This sorting is implicitly carried out by the
-      _current_map.
+      The key of this map is the Zobrist hash of the capture map,
+      which the ICapture maintains as pairs are captured and
+      released. Each contact map is therefore found in O(1) time,
+      and the sorted list of the captured pairs is only built when a
+      new map is first visited.
      */
     CollectedMapType _collected_maps;
     CollectedMapType::iterator _current_map;
     LinksMapType _map_links;
     std::string _interaction_name;
     std::shared_ptr<ICapture> _interaction;
+
+    //! \brief Add the current capture map to the collected maps.
+    CollectedMapType::iterator insertCurrentMap(double energy);
   };
 }
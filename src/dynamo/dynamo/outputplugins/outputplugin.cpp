@@ -28,7 +28,8 @@
 namespace dynamo {
   OutputPlugin::OutputPlugin(const dynamo::Simulation* tmp, const char *aName, unsigned char order):
     SimBase_const(tmp, aName),
-    updateOrder(order)
+    updateOrder(order),
+    _name(aName)
   {
     dout << "Loaded" << std::endl;
   }
@@ -150,6 +151,8 @@ namespace dynamo {
       return testGeneratePlugin<OPRadialDistribution>(Sim, XML);
     else if (!Name.compare("MSDCorrelator"))
       return testGeneratePlugin<OPMSDCorrelator>(Sim, XML);
+    else if (!Name.compare("MSDMultiTau"))
+      return testGeneratePlugin<OPMSDMultiTau>(Sim, XML);
     else if (!Name.compare("VACF"))
       return testGeneratePlugin<OPVACF>(Sim, XML);
     else if (!Name.compare("KEnergyTicker"))
@@ -64,6 +64,8 @@ namespace dynamo {
     virtual void replicaExchange(OutputPlugin&) = 0;
   
     virtual void temperatureRescale(const double&) {}
+
+    const std::string& getPluginName() const { return _name; }
   
   protected:
     std::ostream& I_Pcout() const;
@@ -75,5 +77,7 @@ namespace dynamo {
     //
     // Lets other plugins take data from plugins before/after they are updated
     unsigned char updateOrder;
+
+    std::string _name;
   };
 }
@@ -15,17 +15,16 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <boost/math/special_functions/spherical_harmonic.hpp>
 #include <dynamo/outputplugins/tickerproperty/SHcrystal.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/BC/BC.hpp>
-#include <boost/math/special_functions/spherical_harmonic.hpp>
 #include <magnet/math/wigner3J.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
-#include <fstream>
+#include <functional>
 #include <cmath>
 #include <limits>
 
@@ -33,7 +32,10 @@ namespace dynamo {
   OPSHCrystal::OPSHCrystal(const dynamo::Simulation* tmp, const magnet::xml::Node& XML):
     OPTicker(tmp,"SHCrystal"), rg(1.2), maxl(7),
     nblistID(std::numeric_limits<size_t>::max()),
-    count(0)
+    count(0),
+    _q4hist(0.01),
+    _q6hist(0.01),
+    _w6hist(0.001)
   {
     operator<<(XML);
   }
@@ -76,9 +78,16 @@ namespace dynamo {
       M_throw() << "There is not a suitable neighbourlist for the cut-off radius selected."
 	"\nR_g = " << rg / Sim->units.unitLength();
 
-    globalcoeff.resize(maxl);
-    for (size_t l=0; l < maxl; ++l)
-      globalcoeff[l].resize(2*l+1,std::complex<double>(0,0));
+    globalcoeff.assign(magnet::math::SphericalHarmonicSum::index(maxl, 0), std::complex<double>(0,0));
+
+    _wigner6.assign(13 * 13, 0);
+    for (int m1(-6); m1 <= 6; ++m1)
+      for (int m2(std::max(-6, -6 - m1)); m2 <= std::min(6, 6 - m1); ++m2)
+	_wigner6[(m1 + 6) * 13 + m2 + 6] = magnet::math::wignerThreej(6, 6, 6, m1, m2, -(m1 + m2));
+
+    _localq4.assign(Sim->N(), 0);
+    _localq6.assign(Sim->N(), 0);
+    _localw6.assign(Sim->N(), 0);
 
     ticker();
   }
@@ -86,24 +95,113 @@ namespace dynamo {
   void 
   OPSHCrystal::ticker()
   {
-    sphericalsum ssum(Sim, rg, maxl);
-  
-    for (const Particle& part : Sim->particles)
+    magnet::thread::ThreadPool serialPool;
+    magnet::thread::ThreadPool& pool = Sim->threadPool ? *Sim->threadPool : serialPool;
+
+    std::vector<std::vector<size_t> > domains(std::max(size_t(1), 2 * pool.getThreadCount()));
+    Sim->ptrScheduler->getDomainDecomposition(domains);
+
+    //The local w_6 requires the harmonics up to l=6
+    std::vector<DomainSum> sums(domains.size(), DomainSum(std::max(maxl, size_t(7))));
+    for (size_t d(0); d < domains.size(); ++d)
+      pool.queueTask(std::function<void()>(std::bind(&OPSHCrystal::sampleDomain, this, std::cref(domains[d]), std::ref(sums[d]))));
+    pool.wait();
+
+    for (const DomainSum& sum : sums)
       {
-	std::unique_ptr<IDRange> ids(Sim->ptrScheduler->getParticleNeighbours(part));
-	for (const size_t& id1 : *ids)
-	  ssum(part, id1);
-      
-	for (size_t l(0); l < maxl; ++l)
-	  for (int m(-l); m <= static_cast<int>(l); ++m)
-	    globalcoeff[l][m+l] += ssum.coeffsum[l][m+l];
-      
-	count += ssum.count;
+	for (size_t i(0); i < globalcoeff.size(); ++i)
+	  globalcoeff[i] += sum.coeffsum[i];
+	count += sum.count;
+      }
 
-	ssum.clear();
+    for (size_t i(0); i < Sim->N(); ++i)
+      {
+	_q4hist.addVal(_localq4[i]);
+	_q6hist.addVal(_localq6[i]);
+	_w6hist.addVal(_localw6[i]);
       }
   }
 
+  void
+  OPSHCrystal::sampleDomain(const std::vector<size_t>& domain, DomainSum& sum)
+  {
+    for (const size_t p1 : domain)
+      {
+	const Particle& part = Sim->particles[p1];
+	sum.neighbours.clear();
+	Sim->ptrScheduler->getParticleNeighbours(part, sum.neighbours);
+
+	//Collect the directions of the bonds, so their harmonics
+	//can be evaluated as a block
+	sum.z.clear();
+	sum.x.clear();
+	sum.y.clear();
+	for (const size_t p2 : sum.neighbours)
+	  {
+	    if (p1 == p2) continue;
+	    Vector rij = part.getPosition() - Sim->particles[p2].getPosition();
+	    Sim->BCs->applyBC(rij);
+	    const double norm = rij.nrm();
+	    if (norm > rg) continue;
+	    sum.z.push_back(rij[0] / norm);
+	    sum.x.push_back(rij[1] / norm);
+	    sum.y.push_back(rij[2] / norm);
+	  }
+
+	const size_t bonds = sum.z.size();
+	sum.local.assign(sum.harmonics.size(), std::complex<double>(0,0));
+	sum.harmonics.accumulate(sum.z.data(), sum.x.data(), sum.y.data(), bonds, sum.local.data());
+
+	for (size_t i(0); i < globalcoeff.size(); ++i)
+	  sum.coeffsum[i] += sum.local[i];
+	sum.count += bonds;
+
+	if (bonds)
+	  {
+	    for (std::complex<double>& c : sum.local)
+	      c /= double(bonds);
+	    _localq4[p1] = localQ(sum.local, 4);
+	    _localq6[p1] = localQ(sum.local, 6);
+	    _localw6[p1] = localW6(sum.local);
+	  }
+	else
+	  _localq4[p1] = _localq6[p1] = _localw6[p1] = 0;
+      }
+  }
+
+  std::complex<double>
+  OPSHCrystal::coeff(const std::vector<std::complex<double> >& coeffs, const int l, const int m)
+  {
+    if (m >= 0) return coeffs[magnet::math::SphericalHarmonicSum::index(l, m)];
+    const std::complex<double> c = std::conj(coeffs[magnet::math::SphericalHarmonicSum::index(l, -m)]);
+    return (m % 2) ? -c : c;
+  }
+
+  double
+  OPSHCrystal::localQ(const std::vector<std::complex<double> >& coeffs, const int l)
+  {
+    double sum = 0;
+    for (int m(-l); m <= l; ++m)
+      sum += std::norm(coeff(coeffs, l, m));
+    return std::sqrt(sum * 4.0 * M_PI / (2.0 * l + 1.0));
+  }
+
+  double
+  OPSHCrystal::localW6(const std::vector<std::complex<double> >& coeffs) const
+  {
+    double norm = 0;
+    for (int m(-6); m <= 6; ++m)
+      norm += std::norm(coeff(coeffs, 6, m));
+    if (norm == 0) return 0;
+
+    std::complex<double> sum(0, 0);
+    for (int m1(-6); m1 <= 6; ++m1)
+      for (int m2(std::max(-6, -6 - m1)); m2 <= std::min(6, 6 - m1); ++m2)
+	sum += _wigner6[(m1 + 6) * 13 + m2 + 6] * coeff(coeffs, 6, m1) * coeff(coeffs, 6, m2) * coeff(coeffs, 6, -(m1 + m2));
+
+    return sum.real() * std::pow(norm, -1.5);
+  }
+
   void 
   OPSHCrystal::output(magnet::xml::XmlStream& XML)
   {
@@ -116,7 +214,7 @@ namespace dynamo {
       
 	double Qsum(0);
 	for (int m(-l); m <= l; ++m)
-	  Qsum += std::norm(globalcoeff[l][m+l] / std::complex<double>(count, 0));
+	  Qsum += std::norm(coeff(globalcoeff, l, m) / std::complex<double>(count, 0));
       
 	XML << magnet::xml::attr("val")
 	    << std::sqrt(Qsum * 4.0 * M_PI / (2.0 * l + 1.0))
@@ -133,9 +231,9 @@ namespace dynamo {
 	      if (std::abs(m3) <= l)
 		Wsum += std::complex<double>(magnet::math::wignerThreej(l,l,l,m1,m2,m3) 
 					     * std::pow(count,-3.0), 0)
-		  * globalcoeff[l][m1+l]
-		  * globalcoeff[l][m2+l]
-		  * globalcoeff[l][l-(m1+m2)]
+		  * coeff(globalcoeff, l, m1)
+		  * coeff(globalcoeff, l, m2)
+		  * coeff(globalcoeff, l, m3)
 		  ;
 	    }
       
@@ -144,57 +242,18 @@ namespace dynamo {
 	    << magnet::xml::endtag("W");
       }
 
-    XML << magnet::xml::endtag("SHCrystal");
-  }
-
-  OPSHCrystal::sphericalsum::sphericalsum
-  (const dynamo::Simulation * const nSim, const double& nrg, const size_t& nl):
-    Sim(nSim), rg(nrg), maxl(nl), count(0)
-  {
-    coeffsum.resize(maxl);
-    for (size_t l=0; l < maxl; ++l)
-      coeffsum[l].resize(2*l+1,std::complex<double>(0,0));
-  }
-
-  void 
-  OPSHCrystal::sphericalsum::operator()
-    (const Particle& part, const size_t& ID) const
-  {
-    if (part.getID() == ID) return;
-    Vector rij = part.getPosition() - Sim->particles[ID].getPosition();
-    Sim->BCs->applyBC(rij);
-  
-    double norm = rij.nrm();
-    if (norm <= rg)
-      {
-	++count;
-	rij /= norm;
-	double theta = std::acos(rij[0]);
-	double sintheta = std::sin(theta);
-	double phi = rij[1] / sintheta;
-      
-	if (fabs(phi) > 1.0)
-	  phi = (phi > 0) ? 0.5 * M_PI : 1.5 * M_PI;
-	else
-	  phi = std::asin(phi);
-
-	if (std::sin(theta) == 0) phi = 0;
-      
-	if (phi < 0) phi += 2.0 * M_PI;
-
-	for (size_t l(0); l < maxl; ++l)
-	  for (int m(-l); m <= static_cast<int>(l); ++m)
-	    coeffsum[l][m+l] += boost::math::spherical_harmonic(l,m,theta,phi);
-      }
-  }
-
-  void
-  OPSHCrystal::sphericalsum::clear()
-  {
-    count = 0;
+    XML << magnet::xml::tag("Local")
+	<< magnet::xml::tag("Q") << magnet::xml::attr("l") << 4;
+    _q4hist.outputHistogram(XML, 1.0);
+    XML << magnet::xml::endtag("Q")
+	<< magnet::xml::tag("Q") << magnet::xml::attr("l") << 6;
+    _q6hist.outputHistogram(XML, 1.0);
+    XML << magnet::xml::endtag("Q")
+	<< magnet::xml::tag("W") << magnet::xml::attr("l") << 6;
+    _w6hist.outputHistogram(XML, 1.0);
+    XML << magnet::xml::endtag("W")
+	<< magnet::xml::endtag("Local");
 
-    for (size_t l(0); l < maxl; ++l)
-      for (int m(-l); m <= static_cast<int>(l); ++m)
-	coeffsum[l][m+l] = std::complex<double>(0,0);
+    XML << magnet::xml::endtag("SHCrystal");
   }
 }
@@ -17,11 +17,26 @@
 
 #pragma once
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <magnet/math/spherical_harmonics.hpp>
+#include <magnet/math/histogram.hpp>
 #include <vector>
 #include <complex>
 
 namespace dynamo {
-  class Particle;
+  /*! \brief Calculates the Steinhardt bond order parameters.
+
+    The global \f$Q_l\f$ and \f$W_l\f$ for \f$l<\f$ MaxL are
+    collected from every bond shorter than the cut off radius
+    (CutOffR) over the whole run. Each tick also calculates the local
+    \f$q_4\f$, \f$q_6\f$ and \f$w_6\f$ of every particle from its
+    own bonds, which are available through getLocalQ4() etc. for
+    crystallite detection, and collected into histograms.
+
+    The particles are split into the spatial domains of the
+    Scheduler and sampled in parallel on the thread pool. The
+    spherical harmonics of all the bonds of a particle are evaluated
+    together by a magnet::math::SphericalHarmonicSum.
+   */
   class OPSHCrystal: public OPTicker
   {
   public:
@@ -37,9 +52,37 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    //! \brief The local \f$q_4\f$ of each particle at the last tick.
+    const std::vector<double>& getLocalQ4() const { return _localq4; }
+
+    //! \brief The local \f$q_6\f$ of each particle at the last tick.
+    const std::vector<double>& getLocalQ6() const { return _localq6; }
+
+    //! \brief The local \f$w_6\f$ of each particle at the last tick.
+    const std::vector<double>& getLocalW6() const { return _localw6; }
+
   protected:
+    //! \brief The per-domain accumulators of a tick.
+    struct DomainSum
+    {
+      DomainSum(size_t L): harmonics(L), coeffsum(harmonics.size()), count(0) {}
+
+      magnet::math::SphericalHarmonicSum harmonics;
+      std::vector<std::complex<double> > coeffsum;
+      size_t count;
+      std::vector<std::complex<double> > local;
+      std::vector<size_t> neighbours;
+      std::vector<double> z, x, y;
+    };
+
+    void sampleDomain(const std::vector<size_t>&, DomainSum&);
+
+    //! \brief The summed coefficient of \f$Y_l^m\f$, including \f$m<0\f$.
+    static std::complex<double> coeff(const std::vector<std::complex<double> >&, int l, int m);
+
+    static double localQ(const std::vector<std::complex<double> >&, int l);
 
-    std::complex<double> localq(const Particle& part, int l, int m);
+    double localW6(const std::vector<std::complex<double> >&) const;
 
     //! Cut-off radius 
     double rg;
@@ -47,22 +90,17 @@ namespace dynamo {
     size_t nblistID;
     long count;
   
-    std::vector<std::vector<std::complex<double> > > globalcoeff;
+    //! \brief The summed \f$Y_l^m\f$ of every bond, for \f$m\ge0\f$.
+    std::vector<std::complex<double> > globalcoeff;
 
-    struct sphericalsum
-    {
-      sphericalsum(const dynamo::Simulation * const, 
-		   const double&, const size_t&);
-    
-      void operator()(const Particle&, const size_t&) const;
-    
-      void clear();
-
-      const dynamo::Simulation* const Sim;
-      const double rg;
-      const size_t maxl;
-      mutable size_t count;
-      mutable std::vector<std::vector<std::complex<double> > > coeffsum;
-    };
+    //! \brief The Wigner 3-j symbols for \f$w_6\f$, indexed by \f$m_1\f$ and \f$m_2\f$.
+    std::vector<double> _wigner6;
+
+    std::vector<double> _localq4;
+    std::vector<double> _localq6;
+    std::vector<double> _localw6;
+    magnet::math::Histogram<> _q4hist;
+    magnet::math::Histogram<> _q6hist;
+    magnet::math::Histogram<> _w6hist;
   };
 }
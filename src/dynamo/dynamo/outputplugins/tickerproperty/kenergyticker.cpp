@@ -23,7 +23,7 @@
 namespace dynamo {
   OPKEnergyTicker::OPKEnergyTicker(const dynamo::Simulation* tmp, 
 				   const magnet::xml::Node& XML):
-    OPTicker(tmp,"KEnergyTicker"),
+    OPSnapshotTicker(tmp,"KEnergyTicker"),
     count(0)
   { operator<<(XML); }
 
@@ -40,7 +40,7 @@ namespace dynamo {
   }
 
   void 
-  OPKEnergyTicker::ticker()
+  OPKEnergyTicker::snapshotTicker(const ParticleList& particles)
   {
     ++count;
 
@@ -50,7 +50,7 @@ namespace dynamo {
       for (size_t jDim = 0; jDim < NDIM; ++jDim)
 	localE[iDim][jDim] = 0.0;
 
-    for (const Particle& part : Sim->particles)
+    for (const Particle& part : particles)
       for (size_t iDim = 0; iDim < NDIM; ++iDim)
 	for (size_t jDim = 0; jDim < NDIM; ++jDim)
 	  localE[iDim][jDim] += part.getVelocity()[iDim] * part.getVelocity()[jDim]
@@ -23,7 +23,7 @@
 #include <array>
 
 namespace dynamo {
-  class OPKEnergyTicker: public OPTicker
+  class OPKEnergyTicker: public OPSnapshotTicker
   {
   public:
     OPKEnergyTicker(const dynamo::Simulation*, const magnet::xml::Node&);
@@ -35,7 +35,7 @@ namespace dynamo {
 
     virtual void stream(double) {}
 
-    virtual void ticker();
+    virtual void snapshotTicker(const ParticleList&);
   
     virtual void output(magnet::xml::XmlStream&);
 
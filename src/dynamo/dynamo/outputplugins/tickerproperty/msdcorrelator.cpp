@@ -26,7 +26,7 @@
 namespace dynamo {
   OPMSDCorrelator::OPMSDCorrelator(const dynamo::Simulation* tmp, 
 				   const magnet::xml::Node& XML):
-    OPTicker(tmp,"MSDCorrelator"),
+    OPSnapshotTicker(tmp,"MSDCorrelator"),
     length(20),
     currCorrLength(0),
     ticksTaken(0),
@@ -57,9 +57,9 @@ namespace dynamo {
   }
 
   void 
-  OPMSDCorrelator::ticker()
+  OPMSDCorrelator::snapshotTicker(const ParticleList& particles)
   {
-    for (const Particle& part : Sim->particles)
+    for (const Particle& part : particles)
       posHistory[part.getID()].push_front(part.getPosition());
   
     if (notReady)
@@ -70,11 +70,11 @@ namespace dynamo {
 	notReady = false;
       }
   
-    accPass();
+    accPass(particles);
   }
 
   void
-  OPMSDCorrelator::accPass()
+  OPMSDCorrelator::accPass(const ParticleList& particles)
   {
     ++ticksTaken;
   
@@ -91,7 +91,7 @@ namespace dynamo {
 
 	for (const size_t& ID : *range)
 	  {
-	    double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	    double mass = Sim->species(particles[ID])->getMass(ID);
 	    molCOM += posHistory[ID][0] * mass;
 	    molMass += mass;
 	  }
@@ -104,7 +104,7 @@ namespace dynamo {
 	  
 	    for (const size_t& ID : *range)
 	      molCOM2 += posHistory[ID][step] 
-	      * Sim->species[Sim->particles[ID]]->getMass(ID);
+	      * Sim->species(particles[ID])->getMass(ID);
 	  
 	    molCOM2 /= molMass;
 	  
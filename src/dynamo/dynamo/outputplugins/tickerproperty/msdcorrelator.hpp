@@ -22,7 +22,7 @@
 #include <vector>
 
 namespace dynamo {
-  class OPMSDCorrelator: public OPTicker
+  class OPMSDCorrelator: public OPSnapshotTicker
   {
   public:
     OPMSDCorrelator(const dynamo::Simulation*, const magnet::xml::Node&);
@@ -35,9 +35,9 @@ namespace dynamo {
   
   protected:
     virtual void stream(double) {}
-    virtual void ticker();
+    virtual void snapshotTicker(const ParticleList&);
 
-    void accPass();
+    void accPass(const ParticleList&);
 
     std::vector<boost::circular_buffer<Vector> > posHistory;
     std::vector<std::vector<double> > speciesData;
@@ -0,0 +1,134 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/tickerproperty/msdmultitau.hpp>
+#include <dynamo/include.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/systems/sysTicker.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+
+namespace dynamo {
+  OPMSDMultiTau::OPMSDMultiTau(const dynamo::Simulation* tmp, 
+			       const magnet::xml::Node& XML):
+    OPSnapshotTicker(tmp,"MSDMultiTau"),
+    _points(16),
+    _scaling(2),
+    _collectVACF(false)
+  {
+    operator<<(XML);
+  }
+
+  void 
+  OPMSDMultiTau::operator<<(const magnet::xml::Node& XML)
+  {
+    if (XML.hasAttribute("Points"))
+      _points = XML.getAttribute("Points").as<size_t>();
+
+    if (XML.hasAttribute("Scaling"))
+      _scaling = XML.getAttribute("Scaling").as<size_t>();
+
+    _collectVACF = XML.hasAttribute("VACF");
+  }
+
+  void 
+  OPMSDMultiTau::initialise()
+  {
+    //Order the particles by species, so each species is a contiguous
+    //group of channels
+    _channelIDs.clear();
+    std::vector<size_t> groupEnds;
+    for (const shared_ptr<Species>& sp : Sim->species)
+      {
+	for (const size_t& ID : *sp->getRange())
+	  _channelIDs.push_back(ID);
+	groupEnds.push_back(_channelIDs.size());
+      }
+
+    _sample.resize(_channelIDs.size());
+    _msd.resize(groupEnds, _points, _scaling);
+    if (_collectVACF)
+      _vacf.resize(groupEnds, _points, _scaling);
+
+    dout << "The multi-tau correlator stores " << _points << " samples per level, with a scaling of " << _scaling 
+	 << "\nEach level holds " << _points * _channelIDs.size() * sizeof(Vector) * (_collectVACF ? 2 : 1) / 1024 << "KB" << std::endl;
+
+    for (size_t i(0); i < _channelIDs.size(); ++i)
+      _sample[i] = Sim->particles[_channelIDs[i]].getPosition();
+    _msd.push(_sample);
+
+    if (!_collectVACF) return;
+
+    for (size_t i(0); i < _channelIDs.size(); ++i)
+      _sample[i] = Sim->particles[_channelIDs[i]].getVelocity();
+    _vacf.push(_sample);
+  }
+
+  void 
+  OPMSDMultiTau::snapshotTicker(const ParticleList& particles)
+  {
+    for (size_t i(0); i < _channelIDs.size(); ++i)
+      _sample[i] = particles[_channelIDs[i]].getPosition();
+    _msd.push(_sample);
+
+    if (!_collectVACF) return;
+
+    for (size_t i(0); i < _channelIDs.size(); ++i)
+      _sample[i] = particles[_channelIDs[i]].getVelocity();
+    _vacf.push(_sample);
+  }
+
+  template<class Correlator>
+  void
+  OPMSDMultiTau::outputCorrelator(magnet::xml::XmlStream& XML, const Correlator& correlator, const double unit) const
+  {
+    const double dt = dynamic_cast<const SysTicker&>(*Sim->systems["SystemTicker"]).getPeriod() / Sim->units.unitTime();
+
+    for (const shared_ptr<Species>& sp : Sim->species)
+      {
+	XML << magnet::xml::tag("Species")
+	    << magnet::xml::attr("Name") << sp->getName()
+	    << magnet::xml::chardata();
+
+	for (const typename Correlator::Data& data : correlator.getAveragedCorrelator(sp->getID()))
+	  XML << dt * data.lag << " " << data.value / unit << " " << data.sample_count << "\n";
+
+	XML << magnet::xml::endtag("Species");
+      }
+  }
+
+  void
+  OPMSDMultiTau::output(magnet::xml::XmlStream &XML)
+  {
+    XML << magnet::xml::tag("MSDMultiTau")
+	<< magnet::xml::attr("Points") << _points
+	<< magnet::xml::attr("Scaling") << _scaling
+	<< magnet::xml::attr("Samples") << _msd.getPushCount()
+	<< magnet::xml::tag("MSD");
+    outputCorrelator(XML, _msd, Sim->units.unitArea());
+    XML << magnet::xml::endtag("MSD");
+
+    if (_collectVACF)
+      {
+	XML << magnet::xml::tag("VACF");
+	outputCorrelator(XML, _vacf, Sim->units.unitVelocity() * Sim->units.unitVelocity());
+	XML << magnet::xml::endtag("VACF");
+      }
+
+    XML << magnet::xml::endtag("MSDMultiTau");
+  }
+}
@@ -0,0 +1,88 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <magnet/math/correlators.hpp>
+#include <magnet/math/vector.hpp>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A multiple-tau correlator of the mean square displacement
+      (and optionally the velocity autocorrelation function) of each
+      species.
+
+    Unlike OPMSDCorrelator and OPVACF, which store the full history
+    of every particle over the length of the correlation, this plugin
+    uses a magnet::math::MultiTauCorrelator. The lags are spaced
+    logarithmically, so the correlation can span the whole run while
+    only Points samples per level are stored for each particle.
+
+    The attributes are Points (the samples stored per level, default
+    16), Scaling (the growth in the sample interval between levels,
+    default 2) and VACF (if present, the velocity autocorrelation
+    function is also collected).
+   */
+  class OPMSDMultiTau: public OPSnapshotTicker
+  {
+    struct SquaredDisplacement
+    {
+      double operator()(const Vector& origin, const Vector& now) const
+      { return (now - origin).nrm2(); }
+    };
+
+    struct DotProduct
+    {
+      double operator()(const Vector& origin, const Vector& now) const
+      { return origin | now; }
+    };
+
+  public:
+    typedef magnet::math::MultiTauCorrelator<Vector, SquaredDisplacement> MSDCorrelator;
+    typedef magnet::math::MultiTauCorrelator<Vector, DotProduct> VACFCorrelator;
+
+    OPMSDMultiTau(const dynamo::Simulation*, const magnet::xml::Node&);
+
+    virtual void initialise();
+
+    void output(magnet::xml::XmlStream &); 
+
+    virtual void operator<<(const magnet::xml::Node&);
+
+    //! \brief The MSD correlator, grouped by species ID.
+    const MSDCorrelator& getMSDCorrelator() const { return _msd; }
+
+    //! \brief The VACF correlator, grouped by species ID.
+    const VACFCorrelator& getVACFCorrelator() const { return _vacf; }
+  
+  protected:
+    virtual void stream(double) {}
+    virtual void snapshotTicker(const ParticleList&);
+
+    template<class Correlator>
+    void outputCorrelator(magnet::xml::XmlStream&, const Correlator&, double) const;
+
+    MSDCorrelator _msd;
+    VACFCorrelator _vacf;
+    //! \brief The particle ID of each channel, grouped by species.
+    std::vector<size_t> _channelIDs;
+    std::vector<Vector> _sample;
+    size_t _points;
+    size_t _scaling;
+    bool _collectVACF;
+  };
+}
@@ -44,9 +44,9 @@ namespace dynamo {
   void 
   OPOverlapTest::ticker()
   {
-    for (std::vector<Particle>::const_iterator iPtr = Sim->particles.begin();
+    for (ParticleList::const_iterator iPtr = Sim->particles.begin();
 	 iPtr != Sim->particles.end(); ++iPtr)
-      for (std::vector<Particle>::const_iterator jPtr = iPtr + 1;
+      for (ParticleList::const_iterator jPtr = iPtr + 1;
 	   jPtr != Sim->particles.end(); ++jPtr)
 	Sim->getInteraction(*iPtr, *jPtr)->validateState(*iPtr, *jPtr);
   }
@@ -17,9 +17,12 @@
 
 #include <dynamo/outputplugins/tickerproperty/radialdist.hpp>
 #include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/include.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <functional>
 
 namespace dynamo {
   OPRadialDistribution::OPRadialDistribution(const dynamo::Simulation* tmp, 
@@ -83,6 +86,22 @@ namespace dynamo {
     if (!(Sim->getOutputPlugin<OPMisc>()))
       M_throw() << "Radial Distribution requires the Misc output plugin";
 
+    //Cache the species of each particle for the sampling loops
+    _speciesIDs.resize(Sim->N());
+    for (const Particle& part : Sim->particles)
+      _speciesIDs[part.getID()] = Sim->species(part)->getID();
+
+    //The furthest separation which is binned
+    const double maxDistance = (length - 0.5) * binWidth;
+    if (maxDistance <= Sim->ptrScheduler->getNeighbourhoodDistance())
+      dout << "Sampling using the neighbourhood of the scheduler" << std::endl;
+    else
+      dout << "Sampling over all pairs of particles, as the sampled range "
+	   << maxDistance / Sim->units.unitLength()
+	   << " exceeds the neighbourhood of the scheduler "
+	   << Sim->ptrScheduler->getNeighbourhoodDistance() / Sim->units.unitLength()
+	   << std::endl;
+
     ticker();
   }
 
@@ -108,17 +127,58 @@ namespace dynamo {
       }
     
     ++sampleCount;
-  
-    for (const shared_ptr<Species>& sp1 : Sim->species)
-      for (const shared_ptr<Species>& sp2 : Sim->species)
-	for (const size_t& p1 : *sp1->getRange())
-	  for (const size_t& p2 : *sp2->getRange())
-	    {
-	      Vector  rij = Sim->particles[p1].getPosition() - Sim->particles[p2].getPosition();
-	      Sim->BCs->applyBC(rij);
-	      const size_t i = static_cast<size_t>(rij.nrm() / binWidth + 0.5);
-	      if (i < length) ++data[sp1->getID()][sp2->getID()][i];
-	    }
+
+    //If every binned pair is within the neighbourhood of the
+    //scheduler, only the neighbours of each particle need visiting
+    const bool useNeighbours = (length - 0.5) * binWidth <= Sim->ptrScheduler->getNeighbourhoodDistance();
+
+    magnet::thread::ThreadPool serialPool;
+    magnet::thread::ThreadPool& pool = Sim->threadPool ? *Sim->threadPool : serialPool;
+
+    std::vector<std::vector<size_t> > domains(std::max(size_t(1), 2 * pool.getThreadCount()));
+    Sim->ptrScheduler->getDomainDecomposition(domains);
+
+    const size_t Nspecies = Sim->species.size();
+    std::vector<std::vector<unsigned long> > histograms(domains.size(), std::vector<unsigned long>(Nspecies * Nspecies * length, 0));
+    for (size_t d(0); d < domains.size(); ++d)
+      pool.queueTask(std::function<void()>(std::bind(&OPRadialDistribution::sampleDomain, this, std::cref(domains[d]), std::ref(histograms[d]), useNeighbours)));
+    pool.wait();
+
+    for (const std::vector<unsigned long>& histogram : histograms)
+      for (size_t s1(0); s1 < Nspecies; ++s1)
+	for (size_t s2(0); s2 < Nspecies; ++s2)
+	  for (size_t i(0); i < length; ++i)
+	    data[s1][s2][i] += histogram[(s1 * Nspecies + s2) * length + i];
+  }
+
+  void
+  OPRadialDistribution::sampleDomain(const std::vector<size_t>& domain, std::vector<unsigned long>& histogram, const bool useNeighbours) const
+  {
+    const size_t Nspecies = Sim->species.size();
+    std::vector<size_t> neighbours;
+    for (const size_t p1 : domain)
+      {
+	const Vector r1 = Sim->particles[p1].getPosition();
+	const size_t offset = _speciesIDs[p1] * Nspecies;
+	
+	auto sample = [&](const size_t p2) {
+	  Vector rij = r1 - Sim->particles[p2].getPosition();
+	  Sim->BCs->applyBC(rij);
+	  const size_t i = static_cast<size_t>(rij.nrm() / binWidth + 0.5);
+	  if (i < length) ++histogram[(offset + _speciesIDs[p2]) * length + i];
+	};
+
+	if (useNeighbours)
+	  {
+	    neighbours.clear();
+	    Sim->ptrScheduler->getParticleNeighbours(Sim->particles[p1], neighbours);
+	    for (const size_t p2 : neighbours)
+	      sample(p2);
+	  }
+	else
+	  for (size_t p2(0); p2 < Sim->N(); ++p2)
+	    sample(p2);
+      }
   }
 
   std::vector<std::pair<double, double> > 
@@ -22,6 +22,20 @@
 #include <vector>
 
 namespace dynamo {
+  /*! \brief Samples the radial distribution function, g(r), of each
+      pair of Species.
+
+    If the sampled range fits within the neighbourhood of the
+    Scheduler (e.g., the range of the cells of a neighbour list), only
+    the neighbours of each particle are visited, so each sample takes
+    O(N) time. Otherwise all pairs of particles are visited, which
+    takes O(N^2) time. Set the Length attribute to use the neighbour
+    list for large systems.
+
+    The particles are split into domains which are sampled
+    concurrently if the Simulation has a ThreadPool, each domain
+    filling its own histogram which is then merged into the total.
+   */
   class OPRadialDistribution: public OPTicker
   {
   public:
@@ -41,6 +55,13 @@ namespace dynamo {
     std::vector<std::pair<double, double> > getgrdata(size_t species1ID, size_t species2ID) const;
     double getBinWidth() const { return binWidth; }
   protected:
+    /*! \brief Samples the particle pairs with a first particle in
+        the domain into a flat histogram (indexed by species pair,
+        then bin).
+     */
+    void sampleDomain(const std::vector<size_t>& domain, std::vector<unsigned long>& histogram, bool useNeighbours) const;
+
+    std::vector<size_t> _speciesIDs;
     double binWidth;
     size_t length;
     unsigned long sampleCount;
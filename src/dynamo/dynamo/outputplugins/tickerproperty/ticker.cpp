@@ -25,6 +25,14 @@ namespace dynamo {
     OutputPlugin(t1,t2)
   {}
 
+  OPSnapshotTicker::OPSnapshotTicker(const dynamo::Simulation* t1,const char *t2):
+    OPTicker(t1,t2)
+  {}
+
+  void
+  OPSnapshotTicker::ticker()
+  { snapshotTicker(Sim->particles); }
+
   double 
   OPTicker::getTickerTime() const
   {
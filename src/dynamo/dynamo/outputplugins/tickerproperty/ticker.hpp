@@ -17,6 +17,7 @@
 
 #pragma once
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/particle.hpp>
 
 namespace dynamo {
   /*! \brief An output plugin marker class for periodically 'ticked'
@@ -50,4 +51,29 @@ namespace dynamo {
 
     double getTickerTime() const;
   };
+
+  /*! \brief A ticker plugin which only collects its data from a
+   * snapshot of the particles.
+   *
+   * The plugin must only read the passed ParticleList and the
+   * constant parts of the Simulation (e.g., the Species and the
+   * units) in snapshotTicker(), and not Simulation::particles or any
+   * other state which changes as the simulation runs.
+   *
+   * In exchange, if the SysTicker is asynchronous (see
+   * SysTicker::setAsync) these plugins are passed a copy of the
+   * particles and run in a background thread, in parallel with the
+   * event loop. Otherwise they are passed Simulation::particles
+   * directly. The SysTicker waits for them to finish before the copy
+   * is next taken and before any output is written.
+   */
+  class OPSnapshotTicker: public OPTicker
+  {
+  public:
+    OPSnapshotTicker(const dynamo::Simulation*, const char*);
+
+    virtual void ticker();
+
+    virtual void snapshotTicker(const ParticleList&) = 0;
+  };
 }
@@ -26,7 +26,7 @@
 namespace dynamo {
   OPVACF::OPVACF(const dynamo::Simulation* tmp, 
 				   const magnet::xml::Node& XML):
-    OPTicker(tmp,"VACF"),
+    OPSnapshotTicker(tmp,"VACF"),
     length(50),
     currCorrLength(0),
     ticksTaken(0),
@@ -59,9 +59,9 @@ namespace dynamo {
   }
 
   void 
-  OPVACF::ticker()
+  OPVACF::snapshotTicker(const ParticleList& particles)
   {
-    for (const Particle& part : Sim->particles)
+    for (const Particle& part : particles)
       velHistory[part.getID()].push_front(part.getVelocity());
   
     if (notReady)
@@ -70,11 +70,11 @@ namespace dynamo {
 	notReady = false;
       }
     
-    accPass();
+    accPass(particles);
   }
 
   void
-  OPVACF::accPass()
+  OPVACF::accPass(const ParticleList& particles)
   {
     ++ticksTaken;
   
@@ -91,7 +91,7 @@ namespace dynamo {
 	  
 	  for (const size_t& ID : *range)
 	    {
-	      double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	      double mass = Sim->species(particles[ID])->getMass(ID);
 	      COMvelocity += velHistory[ID][0] * mass;
 	      molMass += mass;
 	    }
@@ -103,7 +103,7 @@ namespace dynamo {
 	      Vector COMvelocity2(0,0,0);
 	      
 	      for (const size_t& ID : *range)
-		COMvelocity2 += velHistory[ID][step] * Sim->species[Sim->particles[ID]]->getMass(ID);
+		COMvelocity2 += velHistory[ID][step] * Sim->species(particles[ID])->getMass(ID);
 	      COMvelocity2 /= molMass;
 	      structData[topo->getID()][step] += COMvelocity | COMvelocity2;
 	    }
@@ -18,6 +18,9 @@
 #pragma once
 
 #include <magnet/math/vector.hpp>
+#include <magnet/exception.hpp>
+#include <iterator>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -128,4 +131,117 @@ namespace dynamo {
     uint32_t _ID;
     uint32_t _state;
   };
+
+  /*! \brief The container of the Particles of a Simulation.
+
+    Particles are accessed by their ID using operator[], and iterating
+    over the container visits the particles in order of their ID, as
+    with a std::vector. However, the Particles may be stored in a
+    different order in memory (see reorder()), so that particles which
+    are close in space are also close in memory. This reduces the
+    cache misses when scanning the neighbours of a particle in large
+    systems.
+
+    As the storage may be reordered, references and pointers to
+    Particles are only valid until the next call to reorder().
+   */
+  class ParticleList
+  {
+    template<class List, class Value>
+    class iterator_base
+    {
+    public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef Particle value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef Value* pointer;
+      typedef Value& reference;
+
+      iterator_base(): _list(NULL), _ID(0) {}
+      iterator_base(List* list, size_t ID): _list(list), _ID(ID) {}
+
+      template<class L2, class V2>
+      iterator_base(const iterator_base<L2, V2>& o): _list(o._list), _ID(o._ID) {}
+
+      reference operator*() const { return (*_list)[_ID]; }
+      pointer operator->() const { return &(*_list)[_ID]; }
+      reference operator[](difference_type n) const { return (*_list)[_ID + n]; }
+
+      iterator_base& operator++() { ++_ID; return *this; }
+      iterator_base operator++(int) { iterator_base tmp(*this); ++_ID; return tmp; }
+      iterator_base& operator--() { --_ID; return *this; }
+      iterator_base operator--(int) { iterator_base tmp(*this); --_ID; return tmp; }
+      iterator_base& operator+=(difference_type n) { _ID += n; return *this; }
+      iterator_base& operator-=(difference_type n) { _ID -= n; return *this; }
+      iterator_base operator+(difference_type n) const { return iterator_base(_list, _ID + n); }
+      iterator_base operator-(difference_type n) const { return iterator_base(_list, _ID - n); }
+      difference_type operator-(const iterator_base& o) const { return difference_type(_ID) - difference_type(o._ID); }
+
+      bool operator==(const iterator_base& o) const { return _ID == o._ID; }
+      bool operator!=(const iterator_base& o) const { return _ID != o._ID; }
+      bool operator<(const iterator_base& o) const { return _ID < o._ID; }
+
+    private:
+      template<class L2, class V2> friend class iterator_base;
+      List* _list;
+      size_t _ID;
+    };
+
+  public:
+    typedef iterator_base<ParticleList, Particle> iterator;
+    typedef iterator_base<const ParticleList, const Particle> const_iterator;
+    typedef Particle value_type;
+
+    Particle& operator[](const size_t ID) { return _storage[_slot[ID]]; }
+    const Particle& operator[](const size_t ID) const { return _storage[_slot[ID]]; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    size_t size() const { return _storage.size(); }
+    bool empty() const { return _storage.empty(); }
+
+    void reserve(const size_t N) { _storage.reserve(N); _slot.reserve(N); }
+
+    //! \brief Adds a Particle, which must have the next sequential ID.
+    void push_back(const Particle& part)
+    {
+      if (part.getID() != size())
+	M_throw() << "Adding a particle with ID " << part.getID() << " but the next ID is " << size();
+      _slot.push_back(_storage.size());
+      _storage.push_back(part);
+    }
+
+    void clear() { _storage.clear(); _slot.clear(); }
+
+    /*! \brief Rearranges the Particles in memory.
+
+      \param IDs The IDs of every particle, in the order they should
+      be stored.
+     */
+    void reorder(const std::vector<size_t>& IDs)
+    {
+      if (IDs.size() != size())
+	M_throw() << "Reordering " << size() << " particles using " << IDs.size() << " IDs";
+
+      std::vector<Particle> storage;
+      storage.reserve(size());
+      for (const size_t& ID : IDs)
+	{
+	  storage.push_back(_storage[_slot[ID]]);
+	  _slot[ID] = storage.size() - 1;
+	}
+      _storage.swap(storage);
+    }
+
+    //! \brief The Particles in the order they are stored in memory.
+    const std::vector<Particle>& getStorage() const { return _storage; }
+
+  private:
+    std::vector<Particle> _storage;
+    //! The position of each Particle in _storage, indexed by ID.
+    std::vector<uint32_t> _slot;
+  };
 }
@@ -206,7 +206,14 @@ namespace dynamo {
 
     inline void outputParticleXMLData(magnet::xml::XmlStream& XML, const size_t pID) const
     { XML << magnet::xml::attr(_name) << getProperty(pID); }
-  
+
+    typedef std::vector<double> Container;
+
+    //! Direct access to the values, used by the binary configuration files.
+    inline const Container& getValues() const { return _values; }
+
+    //! Direct access to the values, used by the binary configuration files.
+    inline Container& getValues() { return _values; }
   
   protected:
     /*! \brief Output an XML representation of the Property to the
@@ -222,7 +229,6 @@ namespace dynamo {
     }
   
     std::string _name;
-    typedef std::vector<double> Container;
     typedef Container::iterator Iterator;
     Container _values;
   };
@@ -251,6 +257,11 @@ namespace dynamo {
   public:
     typedef Container::const_iterator const_iterator;
 
+    //! Iterate over the named properties.
+    const_iterator begin() const { return _namedProperties.begin(); }
+    //! Iterate over the named properties.
+    const_iterator end() const { return _namedProperties.end(); }
+
     /*! \brief Request a handle to a property using a string containing
       the properties name.
 
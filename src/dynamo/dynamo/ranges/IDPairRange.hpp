@@ -23,6 +23,7 @@ namespace dynamo {
   using std::shared_ptr;
   class Simulation;
   class Particle;
+  class IDRange;
 
   class IDPairRange
   {
@@ -37,10 +38,35 @@ namespace dynamo {
       other particle. */
     virtual bool isInRange(const Particle&) const = 0;
 
+    typedef enum {
+      NO_PAIRS,
+      SOME_PAIRS,
+      ALL_PAIRS
+    } PairCoverage;
+
+    /*! \brief Determine how much of the pairings between two sets
+      of particles are within this Range.
+
+      This is used by the Simulation to build its species-pair
+      dispatch table for Interactions. NO_PAIRS or ALL_PAIRS must only
+      be returned when it is certain, SOME_PAIRS is always a safe
+      answer (and is the default) as the pairs are then tested
+      individually using isInRange().
+
+      \param set1 The IDs of the first set of particles.
+      \param set2 The IDs of the second set of particles.
+     */
+    virtual PairCoverage getCoverage(const Simulation& Sim, const IDRange& set1, const IDRange& set2) const
+    { return SOME_PAIRS; }
+
     static IDPairRange* getClass(const magnet::xml::Node&, const dynamo::Simulation*);
     
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const IDPairRange& range);
  protected:
+    /*! \brief Count the particles of a set which are inside an
+        IDRange. */
+    static size_t countInRange(const Simulation& Sim, const IDRange& set, const IDRange& range);
+
     virtual void outputXML(magnet::xml::XmlStream& XML) const = 0;
   };
 }
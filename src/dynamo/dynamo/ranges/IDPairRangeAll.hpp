@@ -31,6 +31,7 @@ namespace dynamo {
 
     virtual bool isInRange(const Particle&, const Particle&) const { return true; }
     virtual bool isInRange(const Particle&) const { return true; }
+    virtual PairCoverage getCoverage(const Simulation&, const IDRange&, const IDRange&) const { return ALL_PAIRS; }
     
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
@@ -28,6 +28,7 @@ namespace dynamo {
     
     virtual bool isInRange(const Particle&, const Particle&) const { return false; }
     virtual bool isInRange(const Particle&) const { return false; }
+    virtual PairCoverage getCoverage(const Simulation&, const IDRange&, const IDRange&) const { return NO_PAIRS; }
   
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
@@ -39,6 +39,23 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return range1->isInRange(p1) || range2->isInRange(p1); }
 
+    virtual PairCoverage getCoverage(const Simulation& Sim, const IDRange& set1, const IDRange& set2) const
+    {
+      const size_t count11 = countInRange(Sim, set1, *range1);
+      const size_t count12 = countInRange(Sim, set1, *range2);
+      const size_t count21 = countInRange(Sim, set2, *range1);
+      const size_t count22 = countInRange(Sim, set2, *range2);
+      
+      if (((count11 == set1.size()) && (count22 == set2.size()))
+	  || ((count12 == set1.size()) && (count21 == set2.size())))
+	return ALL_PAIRS;
+
+      if ((!count11 || !count22) && (!count12 || !count21))
+	return NO_PAIRS;
+
+      return SOME_PAIRS;
+    }
+
   protected:
 
     virtual void outputXML(magnet::xml::XmlStream& XML) const
@@ -36,6 +36,15 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return range->isInRange(p1); }
 
+    virtual PairCoverage getCoverage(const Simulation& Sim, const IDRange& set1, const IDRange& set2) const
+    {
+      const size_t count1 = countInRange(Sim, set1, *range);
+      const size_t count2 = countInRange(Sim, set2, *range);
+      if (!count1 || !count2) return NO_PAIRS;
+      if ((count1 == set1.size()) && (count2 == set2.size())) return ALL_PAIRS;
+      return SOME_PAIRS;
+    }
+
     const shared_ptr<IDRange>& getRange() const { return range; }
 
   protected:
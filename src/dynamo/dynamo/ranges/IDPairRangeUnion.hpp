@@ -54,6 +54,19 @@ namespace dynamo {
       return false;
     }
 
+    virtual PairCoverage getCoverage(const Simulation& Sim, const IDRange& set1, const IDRange& set2) const
+    {
+      PairCoverage coverage = NO_PAIRS;
+      for (const shared_ptr<IDPairRange>& rPtr : ranges)
+	switch (rPtr->getCoverage(Sim, set1, set2))
+	  {
+	  case ALL_PAIRS: return ALL_PAIRS;
+	  case SOME_PAIRS: coverage = SOME_PAIRS; break;
+	  case NO_PAIRS: break;
+	  }
+      return coverage;
+    }
+
     void addRange(IDPairRange* nRange)
     { ranges.push_back(shared_ptr<IDPairRange>(nRange)); }
   
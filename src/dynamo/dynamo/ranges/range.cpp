@@ -16,6 +16,7 @@
 */
 
 #include <dynamo/ranges/include.hpp>
+#include <dynamo/simulation.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 
@@ -29,6 +30,15 @@ namespace dynamo {
     return XML;
   }
 
+  size_t
+  IDPairRange::countInRange(const Simulation& Sim, const IDRange& set, const IDRange& range)
+  {
+    size_t count = 0;
+    for (const size_t ID : set)
+      count += range.isInRange(Sim.particles[ID]);
+    return count;
+  }
+
   magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML,
 				     const IDPairRange& range)
   { 
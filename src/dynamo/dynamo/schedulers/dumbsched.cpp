@@ -19,8 +19,6 @@
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/locals/local.hpp>
-#include <dynamo/ranges/IDRangeAll.hpp>
-#include <dynamo/ranges/IDRangeRange.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath> //for huge val
 
@@ -45,21 +43,24 @@ namespace dynamo {
 	<< magnet::xml::endtag("Sorter");
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleNeighbours(const Particle&) const
+  void
+  SDumb::getParticleNeighbours(const Particle&, std::vector<size_t>& ids) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeAll(Sim));
+    for (size_t ID(0); ID < Sim->N(); ++ID)
+      ids.push_back(ID);
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleNeighbours(const Vector&) const
+  void
+  SDumb::getParticleNeighbours(const Vector&, std::vector<size_t>& ids) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeAll(Sim));
+    for (size_t ID(0); ID < Sim->N(); ++ID)
+      ids.push_back(ID);
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleLocals(const Particle&) const
+  void
+  SDumb::getParticleLocals(const Particle&, std::vector<size_t>& ids) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size() - 1));
+    for (size_t ID(0); ID < Sim->locals.size(); ++ID)
+      ids.push_back(ID);
   }
 }
@@ -29,9 +29,11 @@ namespace dynamo {
     virtual void initialiseNBlist() {}
 
     virtual double getNeighbourhoodDistance() const { return HUGE_VAL; }
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const;
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const;
-    virtual std::unique_ptr<IDRange> getParticleLocals(const Particle&) const;
+    using Scheduler::getParticleNeighbours;
+    using Scheduler::getParticleLocals;
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const;
 
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
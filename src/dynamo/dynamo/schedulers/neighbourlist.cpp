@@ -26,7 +26,6 @@
 #include <dynamo/systems/nblistCompressionFix.hpp>
 #include <dynamo/locals/local.hpp>
 #include <dynamo/locals/localEvent.hpp>
-#include <dynamo/ranges/IDRangeRange.hpp>
 #include <dynamo/BC/include.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath>
@@ -79,13 +78,14 @@ namespace dynamo {
     if (!nblist)
       M_throw() << "The Global named SchedulerNBList is not a neighbour list!";
 
-    if (nblist->getMaxSupportedInteractionLength() < Sim->getLongestInteraction())
+    if (nblist->getRebuildRange() < Sim->getLongestInteraction())
       M_throw() << "Neighbourlist supports too small interaction distances! Supported distance is " 
-		<< nblist->getMaxSupportedInteractionLength() / Sim->units.unitLength() 
+		<< nblist->getRebuildRange() / Sim->units.unitLength() 
 		<< " but the longest interaction distance is " 
 		<< Sim->getLongestInteraction() / Sim->units.unitLength();
 
     nblist->_sigNewNeighbour.connect<Scheduler, &Scheduler::addInteractionEvent>(this);
+    nblist->_sigNewLocal.connect<Scheduler, &Scheduler::addLocalEvent>(this);
     nblist->_sigReInitialise.connect<SNeighbourList, &SNeighbourList::initialise>(this);
     Scheduler::initialise();
   }
@@ -121,8 +121,8 @@ namespace dynamo {
     return static_cast<const GNeighbourList*>(Sim->globals[NBListID].get())->getMaxSupportedInteractionLength();
   }
 
-  std::unique_ptr<IDRange>
-  SNeighbourList::getParticleNeighbours(const Particle& part) const
+  void
+  SNeighbourList::getParticleNeighbours(const Particle& part, std::vector<size_t>& ids) const
   {
 #ifdef DYNAMO_DEBUG
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
@@ -131,13 +131,11 @@ namespace dynamo {
 
     //Grab a reference to the neighbour list
     const GNeighbourList& nblist(*static_cast<const GNeighbourList*>(Sim->globals[NBListID].get()));
-    IDRangeList* range_ptr = new IDRangeList();
-    nblist.getParticleNeighbours(part, range_ptr->getContainer());
-    return std::unique_ptr<IDRange>(range_ptr);
+    nblist.getParticleNeighbours(part, ids);
   }
 
-  std::unique_ptr<IDRange>
-  SNeighbourList::getParticleNeighbours(const Vector& vec) const
+  void
+  SNeighbourList::getParticleNeighbours(const Vector& vec, std::vector<size_t>& ids) const
   {
 #ifdef DYNAMO_DEBUG
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
@@ -145,17 +143,38 @@ namespace dynamo {
 #endif
 
     //Grab a reference to the neighbour list
-    const GNeighbourList& nblist(*static_cast<const GNeighbourList*>
-				 (Sim->globals[NBListID]
-				  .get()));
-  
-    IDRangeList* range_ptr = new IDRangeList();
-    nblist.getParticleNeighbours(vec, range_ptr->getContainer());
-    return std::unique_ptr<IDRange>(range_ptr);
+    const GNeighbourList& nblist(*static_cast<const GNeighbourList*>(Sim->globals[NBListID].get()));
+    nblist.getParticleNeighbours(vec, ids);
   }
     
-  std::unique_ptr<IDRange> 
-  SNeighbourList::getParticleLocals(const Particle& part) const {
-    return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size() - 1));
+  void
+  SNeighbourList::getParticleLocals(const Particle& part, std::vector<size_t>& ids) const {
+#ifdef DYNAMO_DEBUG
+    if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
+      M_throw() << "Not a GNeighbourList!";
+#endif
+
+    const GNeighbourList& nblist(*static_cast<const GNeighbourList*>(Sim->globals[NBListID].get()));
+    nblist.getParticleLocals(part, ids);
+  }
+
+  void
+  SNeighbourList::getDomainDecomposition(std::vector<std::vector<size_t> >& domains) const
+  {
+    if (domains.empty()) return;
+
+    const GNeighbourList& nblist(*static_cast<const GNeighbourList*>(Sim->globals[NBListID].get()));
+    nblist.getDomainDecomposition(domains);
+
+    //Any particles not tracked by the neighbour list are placed in
+    //the first domain.
+    std::vector<bool> assigned(Sim->N(), false);
+    for (const std::vector<size_t>& domain : domains)
+      for (const size_t id : domain)
+	assigned[id] = true;
+
+    for (size_t id(0); id < Sim->N(); ++id)
+      if (!assigned[id])
+	domains.front().push_back(id);
   }
 }
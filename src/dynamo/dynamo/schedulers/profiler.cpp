@@ -0,0 +1,105 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/schedulers/profiler.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/interactions/interaction.hpp>
+#include <dynamo/locals/local.hpp>
+#include <dynamo/globals/global.hpp>
+#include <dynamo/systems/system.hpp>
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <sstream>
+
+namespace dynamo {
+  namespace {
+    void outputCounter(magnet::xml::XmlStream& XML, const char* tagName, const std::string& name,
+		       const EventLoopProfiler::Counter& counter)
+    {
+      using namespace magnet::xml;
+      const double seconds = std::chrono::duration<double>(counter.time).count();
+      XML << tag(tagName)
+	  << attr("Name") << name
+	  << attr("Calls") << counter.calls
+	  << attr("Seconds") << seconds
+	  << attr("MeanMicroSeconds") << 1e6 * seconds / (counter.calls + (counter.calls == 0))
+	  << endtag(tagName);
+    }
+
+    template<class T>
+    const std::string& getObjectName(const T& obj) { return obj.getName(); }
+
+    const std::string& getObjectName(const OutputPlugin& plugin) { return plugin.getPluginName(); }
+
+    template<class Container>
+    void outputCounters(magnet::xml::XmlStream& XML, const char* groupName, const char* tagName,
+			const Container& objects, const std::vector<EventLoopProfiler::Counter>& counters)
+    {
+      XML << magnet::xml::tag(groupName);
+      for (size_t i(0); i < counters.size(); ++i)
+	outputCounter(XML, tagName, getObjectName(*objects[i]), counters[i]);
+      XML << magnet::xml::endtag(groupName);
+    }
+  }
+
+  void
+  EventLoopProfiler::initialise(const Simulation& sim)
+  {
+    _interactions.assign(sim.interactions.size(), Counter());
+    _locals.assign(sim.locals.size(), Counter());
+    _globals.assign(sim.globals.size(), Counter());
+    _systems.assign(sim.systems.size(), Counter());
+    _plugins.assign(sim.outputPlugins.size(), Counter());
+  }
+
+  void
+  EventLoopProfiler::outputXML(magnet::xml::XmlStream& XML, const Simulation& sim) const
+  {
+    using namespace magnet::xml;
+    static const char* phaseNames[PHASE_COUNT] = {"Sort", "LazyDeletion", "Recalculation", "Rejection",
+						  "RunEvent", "FullUpdate", "OutputPlugins", "SystemRebuild"};
+
+    XML << tag("Profile")
+	<< tag("Phases");
+    for (size_t i(0); i < PHASE_COUNT; ++i)
+      outputCounter(XML, "Phase", phaseNames[i], _phases[i]);
+    XML << endtag("Phases")
+	<< tag("EventTypes");
+    for (size_t i(0); i < _eventTypes.size(); ++i)
+      if (_eventTypes[i].calls)
+	{
+	  std::ostringstream os;
+	  os << EEventType(i);
+	  outputCounter(XML, "EventType", os.str(), _eventTypes[i]);
+	}
+    XML << endtag("EventTypes");
+
+    outputCounters(XML, "Interactions", "Interaction", sim.interactions, _interactions);
+    outputCounters(XML, "Locals", "Local", sim.locals, _locals);
+    outputCounters(XML, "Globals", "Global", sim.globals, _globals);
+    outputCounters(XML, "Systems", "System", sim.systems, _systems);
+    outputCounters(XML, "OutputPlugins", "OutputPlugin", sim.outputPlugins, _plugins);
+
+    XML << tag("Rejections")
+	<< attr("Interaction") << _interactionRejections
+	<< attr("Local") << _localRejections
+	<< attr("InteractionWatchdog") << _interactionWatchdog
+	<< attr("LocalWatchdog") << _localWatchdog
+	<< endtag("Rejections")
+	<< endtag("Profile");
+  }
+}
@@ -0,0 +1,172 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/eventtypes.hpp>
+#include <chrono>
+#include <vector>
+
+namespace magnet { namespace xml { class XmlStream; } }
+
+/*! \brief Calls a member function of the Scheduler's \ref
+    dynamo::EventLoopProfiler.
+
+    This expands to nothing unless DynamO is built with
+    DYNAMO_PROFILE defined (e.g., "bjam dynamo-profile=on"), so the
+    arguments are not evaluated in normal builds.
+ */
+#ifdef DYNAMO_PROFILE
+# define DYNAMO_PROFILE_CALL(...) _profiler.__VA_ARGS__
+#else
+# define DYNAMO_PROFILE_CALL(...)
+#endif
+
+namespace dynamo {
+  class Simulation;
+
+  /*! \brief Accumulates the wall time spent in each part of the
+      Scheduler event loop.
+
+    The time of each event is split into the phases of
+    Scheduler::runNextEvent(). The total time of each executed event
+    is also accumulated by its EEventType and by the Interaction,
+    Local, Global or System which generated it, and the time of the
+    output plugin event callbacks are accumulated per plugin. This
+    allows a simulation to be classed as scheduler-bound or
+    physics-bound.
+
+    Output plugins called from within a Local, Global or System
+    event are timed as part of that event.
+
+    The profiler is only compiled into the Scheduler when
+    DYNAMO_PROFILE is defined, and its results are written into the
+    output data file.
+   */
+  class EventLoopProfiler
+  {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    //! \brief The phases of Scheduler::runNextEvent().
+    enum Phase {
+      SORT,           //!< Sorting and updating the FEL.
+      LAZY_DELETION,  //!< Discarding invalidated events from the FEL.
+      RECALCULATION,  //!< Recalculating the next event before it is run.
+      REJECTION,      //!< Rebuilding the events of a rejected event.
+      RUN_EVENT,      //!< Streaming the system and executing the event.
+      FULL_UPDATE,    //!< Rebuilding the events of the particles after an event.
+      OUTPUT_PLUGINS, //!< The output plugin callbacks of Interaction events.
+      SYSTEM_REBUILD, //!< Rebuilding the System events.
+      PHASE_COUNT
+    };
+
+    struct Counter
+    {
+      Counter(): calls(0), time(Clock::duration::zero()) {}
+      size_t calls;
+      Clock::duration time;
+
+      void add(Clock::duration dt) { ++calls; time += dt; }
+    };
+
+    EventLoopProfiler():
+      _interactionRejections(0), _localRejections(0),
+      _interactionWatchdog(0), _localWatchdog(0),
+      _eventTypes(FINAL_ENUM_TO_CATCH_THE_COMMA)
+    {}
+
+    //! \brief Size the counters to the Simulation's classes.
+    void initialise(const Simulation&);
+
+    //! \brief Mark the start of an event loop iteration.
+    void lap() { _eventStart = _last = Clock::now(); }
+
+    //! \brief Add the time since the last lap to a phase.
+    void lap(Phase phase)
+    {
+      const Clock::time_point now = Clock::now();
+      _phases[phase].add(now - _last);
+      _last = now;
+    }
+
+    //! \brief Add the time since the last lap to an output plugin
+    //! (and the OUTPUT_PLUGINS phase).
+    void lap(Phase phase, size_t pluginID)
+    {
+      const Clock::time_point now = Clock::now();
+      _phases[phase].add(now - _last);
+      _plugins[pluginID].add(now - _last);
+      _last = now;
+    }
+
+    /*! \brief Add the time since the start of the event loop
+        iteration to the executed event.
+
+      \param type The EEventType of the executed event.
+      \param source The event type of the generating class (e.g.,
+      INTERACTION, LOCAL, GLOBAL or SYSTEM).
+      \param ID The ID of the generating class.
+     */
+    void event(EEventType type, EEventType source, size_t ID)
+    {
+      const Clock::duration dt = Clock::now() - _eventStart;
+      _eventTypes[type].add(dt);
+      switch (source)
+	{
+	case INTERACTION: _interactions[ID].add(dt); break;
+	case LOCAL: _locals[ID].add(dt); break;
+	case GLOBAL: _globals[ID].add(dt); break;
+	case SYSTEM: _systems[ID].add(dt); break;
+	default: break;
+	}
+    }
+
+    /*! \brief Record a rejected Interaction (true) or Local (false)
+        event.
+     */
+    void rejection(bool interaction)
+    { ++(interaction ? _interactionRejections : _localRejections); }
+
+    /*! \brief Record if an out of sequence Interaction (true) or
+        Local (false) event was accepted by the rejection watchdog.
+     */
+    void watchdog(bool interaction, bool triggered)
+    {
+      if (triggered)
+	++(interaction ? _interactionWatchdog : _localWatchdog);
+    }
+
+    void outputXML(magnet::xml::XmlStream&, const Simulation&) const;
+
+  private:
+    Clock::time_point _eventStart;
+    Clock::time_point _last;
+
+    size_t _interactionRejections;
+    size_t _localRejections;
+    size_t _interactionWatchdog;
+    size_t _localWatchdog;
+
+    Counter _phases[PHASE_COUNT];
+    std::vector<Counter> _eventTypes;
+    std::vector<Counter> _interactions;
+    std::vector<Counter> _locals;
+    std::vector<Counter> _globals;
+    std::vector<Counter> _systems;
+    std::vector<Counter> _plugins;
+  };
+}
@@ -23,16 +23,21 @@
 #include <dynamo/locals/local.hpp>
 #include <dynamo/systems/system.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/interactions/stepped.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/ranges/IDRangeList.hpp>
 #ifdef DYNAMO_DEBUG
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #endif
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <typeinfo>
 
 namespace dynamo {
   Scheduler::Scheduler(dynamo::Simulation* const tmp, const char * aName,
@@ -64,10 +69,12 @@ namespace dynamo {
 	warnings += interaction_ptr->validateState(warnings < 101, 101 - warnings);
       }
     
+    std::vector<size_t> ids;
     for (size_t id1(0); id1 < Sim->particles.size(); ++id1)
       {
-	std::unique_ptr<IDRange> ids(getParticleNeighbours(Sim->particles[id1]));
-	for (const size_t id2 : *ids)
+	ids.clear();
+	getParticleNeighbours(Sim->particles[id1], ids);
+	for (const size_t id2 : ids)
 	  if (id2 > id1)
 	    if (Sim->getInteraction(Sim->particles[id1], Sim->particles[id2])
 		->validateState(Sim->particles[id1], Sim->particles[id2], (warnings < 101)))
@@ -85,6 +92,10 @@ namespace dynamo {
 
     dout << "Building all events on collision " << Sim->eventCount << std::endl;
     rebuildList();
+
+#ifdef DYNAMO_PROFILE
+    _profiler.initialise(*Sim);
+#endif
   }
 
   void
@@ -96,8 +107,11 @@ namespace dynamo {
     eventCount.clear();
     eventCount.resize(Sim->N()+1, 0);
 
-    for (Particle& part : Sim->particles)
-      addEvents(part);
+    if (canRebuildConcurrently())
+      rebuildListConcurrently();
+    else
+      for (Particle& part : Sim->particles)
+	addEvents(part);
   
     sorter->init();
 
@@ -116,15 +130,144 @@ namespace dynamo {
 	sorter->push(glob->getEvent(part), part.getID());
   
     //Add the local cell events
-    std::unique_ptr<IDRange> ids(getParticleLocals(part));
-    
-    for (const size_t id2 : *ids)
+    _neighbourIDs.clear();
+    getParticleLocals(part, _neighbourIDs);
+    for (const size_t id2 : _neighbourIDs)
       addLocalEvent(part, id2);
 
     //Now add the interaction events
-    ids = getParticleNeighbours(part);
-    for (const size_t id2 : *ids)
-      addInteractionEvent(part, id2);
+    _neighbourIDs.clear();
+    getParticleNeighbours(part, _neighbourIDs);
+    addInteractionEvents(part, _neighbourIDs);
+  }
+
+  std::unique_ptr<IDRange>
+  Scheduler::getParticleNeighbours(const Particle& part) const
+  {
+    IDRangeList* range_ptr = new IDRangeList();
+    getParticleNeighbours(part, range_ptr->getContainer());
+    return std::unique_ptr<IDRange>(range_ptr);
+  }
+
+  std::unique_ptr<IDRange>
+  Scheduler::getParticleNeighbours(const Vector& vec) const
+  {
+    IDRangeList* range_ptr = new IDRangeList();
+    getParticleNeighbours(vec, range_ptr->getContainer());
+    return std::unique_ptr<IDRange>(range_ptr);
+  }
+
+  std::unique_ptr<IDRange>
+  Scheduler::getParticleLocals(const Particle& part) const
+  {
+    IDRangeList* range_ptr = new IDRangeList();
+    getParticleLocals(part, range_ptr->getContainer());
+    return std::unique_ptr<IDRange>(range_ptr);
+  }
+
+  void
+  Scheduler::addInteractionEvents(const Particle& part, const std::vector<size_t>& ids) const
+  {
+    _interactionBatches.resize(Sim->interactions.size());
+    for (std::vector<size_t>& batch : _interactionBatches)
+      batch.clear();
+
+    for (const size_t id2 : ids)
+      {
+	if (id2 == part.getID()) continue;
+	Particle& part2 = Sim->particles[id2];
+	Sim->dynamics->updateParticle(part2);
+	_interactionBatches[Sim->getInteraction(part, part2)->getID()].push_back(id2);
+      }
+
+    for (size_t i(0); i < _interactionBatches.size(); ++i)
+      if (!_interactionBatches[i].empty())
+	{
+	  Sim->interactions[i]->getEvents(part, _interactionBatches[i], _batchEvents);
+	  for (const IntEvent& eevent : _batchEvents)
+	    sorter->push(Event(eevent, eventCount[eevent.getParticle2ID()]), part.getID());
+	}
+  }
+
+  bool
+  Scheduler::canRebuildConcurrently() const
+  {
+    if (!Sim->threadPool || !Sim->threadPool->getThreadCount())
+      return false;
+
+    //Other Dynamics (e.g., DynGravity) cache intermediate results
+    //during the event calculations.
+    if (typeid(*Sim->dynamics) != typeid(DynNewtonian))
+      return false;
+
+    //Potentials are lazily evaluated as steps are accessed
+    for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+      if (std::dynamic_pointer_cast<const IStepped>(interaction))
+	return false;
+
+    return true;
+  }
+
+  void
+  Scheduler::rebuildListConcurrently()
+  {
+    std::vector<std::vector<size_t> > domains(2 * Sim->threadPool->getThreadCount());
+    getDomainDecomposition(domains);
+
+    dout << "Building Interaction events concurrently over " << domains.size() << " domains" << std::endl;
+
+    //Bring all particles up to date, the Interaction event
+    //calculations are then free to read any particle without
+    //modifying it.
+    Sim->dynamics->updateAllParticles();
+
+    //Globals and Locals are free to cache data during their event
+    //calculations, so these are added serially.
+    for (Particle& part : Sim->particles)
+      {
+	for (const shared_ptr<Global>& glob : Sim->globals)
+	  if (glob->isInteraction(part))
+	    sorter->push(glob->getEvent(part), part.getID());
+
+	_neighbourIDs.clear();
+	getParticleLocals(part, _neighbourIDs);
+	for (const size_t id2 : _neighbourIDs)
+	  addLocalEvent(part, id2);
+      }
+
+    for (const std::vector<size_t>& domain : domains)
+      Sim->threadPool->queueTask(std::function<void()>(std::bind(&Scheduler::addDomainInteractionEvents, this, std::cref(domain))));
+
+    Sim->threadPool->wait();
+  }
+
+  void
+  Scheduler::addDomainInteractionEvents(const std::vector<size_t>& domain) const
+  {
+    //Each domain is processed by one thread, so it has its own buffer
+    std::vector<size_t> ids;
+    for (const size_t id1 : domain)
+      {
+	const Particle& p1 = Sim->particles[id1];
+	ids.clear();
+	getParticleNeighbours(p1, ids);
+	for (const size_t id2 : ids)
+	  {
+	    if (id1 == id2) continue;
+	    const IntEvent eevent(Sim->getEvent(p1, Sim->particles[id2]));
+	    if (eevent.getType() != NONE)
+	      sorter->push(Event(eevent, eventCount[id2]), id1);
+	  }
+      }
+  }
+
+  void
+  Scheduler::getDomainDecomposition(std::vector<std::vector<size_t> >& domains) const
+  {
+    const size_t ndomains = domains.size();
+    if (!ndomains) return;
+    for (size_t i(0); i < Sim->N(); ++i)
+      domains[(i * ndomains) / Sim->N()].push_back(i);
   }
 
   shared_ptr<Scheduler>
@@ -185,7 +328,9 @@ namespace dynamo {
   void
   Scheduler::runNextEvent()
   {
+    DYNAMO_PROFILE_CALL(lap());
     sorter->sort();
+    DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::SORT));
 
 #ifdef DYNAMO_DEBUG
     if (sorter->empty())
@@ -193,6 +338,7 @@ namespace dynamo {
 #endif
 
     lazyDeletionCleanup();
+    DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::LAZY_DELETION));
 
     std::pair<size_t, Event> next_event = sorter->next();
 
@@ -255,7 +401,9 @@ namespace dynamo {
 	  sorter->popNextEvent();
 	  sorter->update(next_event.first);
 	  sorter->sort();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::SORT));
 	  lazyDeletionCleanup();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::LAZY_DELETION));
 
 	  //Now recalculate the current FEL event (to check if
 	  //accumilation of numerical errors have caused the order of
@@ -263,6 +411,7 @@ namespace dynamo {
 	  //the event.
 	  Sim->dynamics->updateParticlePair(p1, p2);
 	  IntEvent Event(Sim->getEvent(p1, p2));
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RECALCULATION));
 	
 	  //Now check if the recalculated event is still the first
 	  //event in the FEL. If not, force a recalculation of this
@@ -281,9 +430,13 @@ namespace dynamo {
 	  if ((Event.getType() == NONE) || ((Event.getdt() > next_event.second.dt) && (++_interactionRejectionCounter < rejectionLimit)))
 	    {
 	      this->fullUpdate(p1, p2);
+	      DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::REJECTION));
+	      DYNAMO_PROFILE_CALL(rejection(true));
 	      return;
 	    }
 
+	  DYNAMO_PROFILE_CALL(watchdog(true, Event.getdt() > next_event.second.dt));
+
 	  //Reset the rejection watchdog counter as we are about to
 	  //run an interaction event now
 	  _interactionRejectionCounter = 0;
@@ -316,9 +469,15 @@ namespace dynamo {
 	  Sim->stream(Event.getdt());
 	  PairEventData eventdata = Sim->interactions[Event.getInteractionID()]->runEvent(p1, p2, Event);
 	  Sim->_sigParticleUpdate(eventdata);
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RUN_EVENT));
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(Event, eventdata);
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::FULL_UPDATE));
+	  for (size_t i(0); i < Sim->outputPlugins.size(); ++i)
+	    {
+	      Sim->outputPlugins[i]->eventUpdate(Event, eventdata);
+	      DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::OUTPUT_PLUGINS, i));
+	    }
+	  DYNAMO_PROFILE_CALL(event(Event.getType(), INTERACTION, Event.getInteractionID()));
 	  break;
 	}
       case GLOBAL:
@@ -336,6 +495,8 @@ namespace dynamo {
 	  //Global events! (Check, some events might rely on this
 	  //behavior)
 	  Sim->globals[next_event.second.globalID]->runEvent(Sim->particles[next_event.first], next_event.second.dt);
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RUN_EVENT));
+	  DYNAMO_PROFILE_CALL(event(GLOBAL, GLOBAL, next_event.second.globalID));
 	  break;	           
 	}
       case LOCAL:
@@ -355,10 +516,13 @@ namespace dynamo {
 	  sorter->popNextEvent();
 	  sorter->update(next_event.first);
 	  sorter->sort();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::SORT));
 	  lazyDeletionCleanup();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::LAZY_DELETION));
 
 	  Sim->dynamics->updateParticle(part);
 	  LocalEvent iEvent(Sim->locals[localID]->getEvent(part));
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RECALCULATION));
 
 	  next_event = sorter->next();
 	  //Check the recalculated event is valid and not later than
@@ -366,9 +530,13 @@ namespace dynamo {
 	  if ((iEvent.getType() == NONE) || ((iEvent.getdt() > next_event.second.dt) && (++_localRejectionCounter < rejectionLimit)))
 	    {
 	      this->fullUpdate(part);
+	      DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::REJECTION));
+	      DYNAMO_PROFILE_CALL(rejection(false));
 	      return;
 	    }
 
+	  DYNAMO_PROFILE_CALL(watchdog(false, iEvent.getdt() > next_event.second.dt));
+
 	  _localRejectionCounter = 0;
 
 #ifdef DYNAMO_DEBUG 
@@ -389,6 +557,8 @@ namespace dynamo {
 	  Sim->stream(iEvent.getdt());
 	
 	  Sim->locals[localID]->runEvent(part, iEvent);	  
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RUN_EVENT));
+	  DYNAMO_PROFILE_CALL(event(iEvent.getType(), LOCAL, localID));
 	  break;
 	}
       case SYSTEM:
@@ -404,8 +574,11 @@ namespace dynamo {
 		      << "\nSystem (ID=" << next_event.second.systemID << ")= " << Sim->systems[next_event.second.systemID]->getName()
 	      ;
 	  Sim->systems[next_event.second.systemID]->runEvent();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::RUN_EVENT));
 	  //This saves the system events rebuilding themselves
 	  rebuildSystemEvents();
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::SYSTEM_REBUILD));
+	  DYNAMO_PROFILE_CALL(event(SYSTEM, SYSTEM, next_event.second.systemID));
 	  break;
 	}
       case RECALCULATE:
@@ -413,6 +586,8 @@ namespace dynamo {
 	  //This is a special event type which requires that the
 	  // events for this particle recalculated.
 	  this->fullUpdate(Sim->particles[next_event.first]);
+	  DYNAMO_PROFILE_CALL(lap(EventLoopProfiler::FULL_UPDATE));
+	  DYNAMO_PROFILE_CALL(event(RECALCULATE, RECALCULATE, 0));
 	  break;
 	}
       case NONE:
@@ -454,7 +629,7 @@ namespace dynamo {
   Scheduler::lazyDeletionCleanup()
   {
     std::pair<size_t, Event> next_event = sorter->next();
-    while ((next_event.second.type == INTERACTION) && (next_event.second.collCounter2 != eventCount[next_event.second.particle2ID]))
+    while ((next_event.second.type == INTERACTION) && !next_event.second.counterMatches(eventCount[next_event.second.particle2ID]))
       {
 	//Not valid, update the list
 	sorter->popNextEvent();
@@ -18,6 +18,7 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/profiler.hpp>
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/globals/globEvent.hpp>
 #include <magnet/function/delegate.hpp>
@@ -105,12 +106,44 @@ namespace dynamo {
     
     
     virtual double getNeighbourhoodDistance() const = 0;
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const = 0;
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const = 0;
-    virtual std::unique_ptr<IDRange> getParticleLocals(const Particle&) const = 0;
+
+    /*! \brief Appends the IDs of the particles in the neighbourhood
+        of a particle to ids.
+
+      This does not allocate if ids already has the capacity, so
+      reusing the same container avoids an allocation per query.
+     */
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>& ids) const = 0;
+
+    //! \brief Appends the IDs of the particles in the neighbourhood of a point to ids.
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>& ids) const = 0;
+
+    //! \brief Appends the IDs of the Locals which may interact with a particle to ids.
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>& ids) const = 0;
+
+    std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const;
+    std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const;
+    std::unique_ptr<IDRange> getParticleLocals(const Particle&) const;
+
+    /*! \brief Splits the particles of the Simulation into domains
+        which may be processed concurrently.
+
+      Every particle is placed in exactly one domain. The default
+      implementation splits the particles into contiguous blocks of
+      IDs.
+
+      \param domains The container to fill with the particle IDs of
+      each domain. Its size on entry sets the number of domains
+      requested.
+     */
+    virtual void getDomainDecomposition(std::vector<std::vector<size_t> >& domains) const;
     
     const std::vector<size_t>& getEventCounts() const { return eventCount; }
 
+#ifdef DYNAMO_PROFILE
+    const EventLoopProfiler& getProfiler() const { return _profiler; }
+#endif
+
   protected:
     /*! \brief Performs the lazy deletion algorithm to find the next
       valid event in the queue.
@@ -121,12 +154,60 @@ namespace dynamo {
      */
     void lazyDeletionCleanup();
 
+    /*! \brief Tests if the initial events of the particles may be
+        calculated concurrently using the Simulation's ThreadPool.
+
+      This requires a ThreadPool with worker threads, and that the
+      Dynamics and Interaction event calculations do not modify any
+      cached state.
+     */
+    bool canRebuildConcurrently() const;
+
+    /*! \brief Builds the events of all particles, calculating the
+        Interaction events of each spatial domain concurrently.
+
+      Each particle only belongs to one domain and the
+      Interaction events are only pushed into the PEL of the owning
+      particle, so the domains do not need to synchronise with each
+      other. The resulting FEL is identical to a serial rebuild.
+
+      Only these full rebuilds are parallel; the events are always
+      executed one at a time by the event loop.
+     */
+    void rebuildListConcurrently();
+
+    /*! \brief Adds the Interaction events of the particles in a
+        single domain, used by rebuildListConcurrently().
+     */
+    void addDomainInteractionEvents(const std::vector<size_t>&) const;
+
+    /*! \brief Adds the Interaction events between a particle and its
+        neighbours.
+
+      The neighbours are grouped by the Interaction which they use,
+      then each group is passed to Interaction::getEvents so that
+      the events may be calculated as a batch.
+     */
+    void addInteractionEvents(const Particle&, const std::vector<size_t>&) const;
+
+    //! \brief Storage for the neighbour and Local IDs queried by addEvents().
+    mutable std::vector<size_t> _neighbourIDs;
+
+    //! \brief Storage for the neighbour IDs grouped by Interaction, used by addInteractionEvents().
+    mutable std::vector<std::vector<size_t> > _interactionBatches;
+    //! \brief Storage for the events calculated by addInteractionEvents().
+    mutable std::vector<IntEvent> _batchEvents;
+
     mutable shared_ptr<FEL> sorter;
     mutable std::vector<size_t> eventCount;
   
     size_t _interactionRejectionCounter;
     size_t _localRejectionCounter;
 
+#ifdef DYNAMO_PROFILE
+    EventLoopProfiler _profiler;
+#endif
+
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
   };
 }
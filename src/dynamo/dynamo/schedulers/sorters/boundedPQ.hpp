@@ -31,6 +31,9 @@ namespace dynamo {
   template<size_t Size>
   class PELMinMax;
 
+  template<size_t Size>
+  class PELInline;
+
   class PELSingleEvent;
 
   template<class T> struct FELBoundedPQName;
@@ -47,6 +50,12 @@ namespace dynamo {
     inline static std::string name() { return std::string("BoundedPQMinMax") + boost::lexical_cast<std::string>(I); }
   };
 
+  template<size_t I>
+  struct FELBoundedPQName<PELInline<I> >
+  {
+    inline static std::string name() { return std::string("BoundedPQInline") + boost::lexical_cast<std::string>(I); }
+  };
+
   template<>
   struct FELBoundedPQName<PELSingleEvent>
   {
@@ -243,7 +252,7 @@ namespace dynamo {
     inline size_t next_ID() const { return CBT[1] - 1; }
     inline EEventType next_type() const { return Min[CBT[1]].data.top().type; }
     inline unsigned long next_collCounter2() const { return Min[CBT[1]].data.top().collCounter2; }
-    inline size_t next_p2() const { return Min[CBT[1]].data.top().p2; }
+    inline size_t next_p2() const { return Min[CBT[1]].data.top().particle2ID; }
 
     inline double next_dt() const { return Min[CBT[1]].data.getdt() - pecTime; }
 
@@ -35,22 +35,31 @@ namespace dynamo {
       events cause the system to be moved forward in time and the
       events for the particle are recalculated. This can all be
       handled by the scheduler.
+
+      As the FEL holds several events per particle, the event is
+      packed into 16 bytes. The IDs are stored in 32 bits and the
+      event counter of the second particle is wrapped to
+      counterBits bits, with the event type packed in the remaining
+      bits. Use counterMatches() to compare the stored counter.
    */
   class Event
   {
   public:   
+    //! \brief The number of bits of the event counter which are stored.
+    static const size_t counterBits = 27;
+
     inline Event():
       dt(HUGE_VAL),
-      collCounter2(std::numeric_limits<unsigned long>::max()),
+      collCounter2(wrapCounter(std::numeric_limits<unsigned long>::max())),
       type(NONE)
     {
-      extraID = std::numeric_limits<size_t>::max();
+      extraID = std::numeric_limits<uint32_t>::max();
     }
 
     inline Event(const double& ndt, const EEventType& nT, 
 		 const size_t& nID2, const unsigned long & nCC2) throw():
       dt(ndt),
-      collCounter2(nCC2),
+      collCounter2(wrapCounter(nCC2)),
       type(nT)
     {
       extraID = nID2;
@@ -58,7 +67,7 @@ namespace dynamo {
 
     inline Event(const IntEvent& coll, const unsigned long& nCC2) throw():
       dt(coll.getdt()),
-      collCounter2(nCC2),
+      collCounter2(wrapCounter(nCC2)),
       type(INTERACTION)
     {
       particle2ID = coll.getParticle2ID();
@@ -89,15 +98,32 @@ namespace dynamo {
 
     inline void stream(const double& ndt) throw() { dt -= ndt; }
 
+    /*! \brief Tests if the stored event counter of the second
+        particle matches its current event counter.
+
+      The counter is wrapped, so a stale event is only mistaken for a
+      valid one if the second particle runs an exact multiple of
+      2^counterBits events while the event is queued.
+     */
+    inline bool counterMatches(const size_t count) const throw()
+    { return collCounter2 == wrapCounter(count); }
+
     mutable double dt;
-    unsigned long collCounter2;
-    EEventType type;
+    uint32_t collCounter2 : counterBits;
+    EEventType type : 32 - counterBits;
     union {
-      size_t particle2ID;
-      size_t localID;
-      size_t globalID;
-      size_t systemID;
-      size_t extraID;
+      uint32_t particle2ID;
+      uint32_t localID;
+      uint32_t globalID;
+      uint32_t systemID;
+      uint32_t extraID;
     };
+
+  private:
+    inline static uint32_t wrapCounter(const size_t count) throw()
+    { return count & ((uint32_t(1) << counterBits) - 1); }
   };
+
+  static_assert(sizeof(Event) == 16, "The Event is expected to pack into 16 bytes");
+  static_assert(FINAL_ENUM_TO_CATCH_THE_COMMA <= (1 << (32 - Event::counterBits)), "Too many event types to pack into the Event");
 }
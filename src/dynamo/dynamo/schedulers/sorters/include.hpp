@@ -17,5 +17,7 @@
 
 #include <dynamo/schedulers/sorters/cbt.hpp>
 #include <dynamo/schedulers/sorters/boundedPQ.hpp>
+#include <dynamo/schedulers/sorters/ladder.hpp>
 #include <dynamo/schedulers/sorters/MinMaxHeapPEL.hpp>
+#include <dynamo/schedulers/sorters/inlinePEL.hpp>
 #include <dynamo/schedulers/sorters/singleeventPEL.hpp>
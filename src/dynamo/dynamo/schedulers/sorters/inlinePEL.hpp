@@ -0,0 +1,141 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <array>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A binary heap Particle Event List which stores its first
+      Size events inline.
+
+    Like PELHeap, every event pushed is kept, but the first Size
+    events are stored in the PEL itself. As the FELs store their PELs
+    in a single array, the events of every particle then share one
+    contiguous allocation. Only particles with more than Size events
+    spill the remainder into an overflow vector, which keeps its
+    capacity when the PEL is cleared, so the allocator is rarely
+    touched by push() and clear().
+
+    As with PELMinMax, the top element is set to HUGE_VAL whenever the
+    PEL is empty, so no conditional logic is required to compare
+    empty PELs.
+
+    \tparam Size The number of events stored inline.
+  */
+  template<size_t Size>
+  class PELInline
+  {
+    static_assert(Size > 0, "PELInline must store at least one event inline");
+  public:
+    PELInline():_count(0) {}
+
+    inline bool empty() const { return _count == 0; }
+    inline size_t size() const { return _count; }
+
+    inline const Event& top() const { return _inline[0]; }
+
+    inline void clear() {
+      _count = 0;
+      _overflow.clear();
+      _inline[0].dt = HUGE_VAL;
+    }
+
+    inline void push(const Event& event) {
+      if (_count < Size)
+	_inline[_count] = event;
+      else
+	_overflow.push_back(event);
+
+      //Percolate up
+      size_t i = _count++;
+      while (i && (event < at((i - 1) / 2)))
+	{
+	  at(i) = at((i - 1) / 2);
+	  i = (i - 1) / 2;
+	}
+      at(i) = event;
+    }
+
+    inline void pop() {
+      if (--_count == 0)
+	{
+	  clear();
+	  return;
+	}
+
+      const Event last = at(_count);
+      if (_count >= Size) _overflow.pop_back();
+
+      //Percolate down
+      size_t i = 0;
+      for (size_t child = 1; child < _count; child = 2 * i + 1)
+	{
+	  if ((child + 1 < _count) && (at(child + 1) < at(child))) ++child;
+	  if (!(at(child) < last)) break;
+	  at(i) = at(child);
+	  i = child;
+	}
+      at(i) = last;
+    }
+
+    inline bool operator> (const PELInline& ip) const { return _inline[0].dt > ip._inline[0].dt; }
+
+    inline bool operator< (const PELInline& ip) const { return _inline[0].dt < ip._inline[0].dt; }
+
+    inline double getdt() const { return _inline[0].dt; }
+
+    inline void stream(const double& ndt) {
+      for (size_t i(0); i < std::min(_count, Size); ++i)
+	_inline[i].dt -= ndt;
+      for (Event& dat : _overflow)
+	dat.dt -= ndt;
+    }
+
+    inline void rescaleTimes(const double& scale) {
+      for (size_t i(0); i < std::min(_count, Size); ++i)
+	_inline[i].dt *= scale;
+      for (Event& dat : _overflow)
+	dat.dt *= scale;
+    }
+
+    inline void swap(PELInline& rhs) {
+      std::swap(_inline, rhs._inline);
+      std::swap(_overflow, rhs._overflow);
+      std::swap(_count, rhs._count);
+    }
+
+  private:
+    inline Event& at(const size_t i) { return (i < Size) ? _inline[i] : _overflow[i - Size]; }
+    inline const Event& at(const size_t i) const { return (i < Size) ? _inline[i] : _overflow[i - Size]; }
+
+    std::array<Event, Size> _inline;
+    std::vector<Event> _overflow;
+    size_t _count;
+  };
+}
+
+namespace std
+{
+  /*! \brief Template specialisation of the std::swap function for PELInline*/
+  template<size_t Size>
+  void swap(dynamo::PELInline<Size>& lhs, dynamo::PELInline<Size>& rhs)
+  {
+    lhs.swap(rhs);
+  }
+}
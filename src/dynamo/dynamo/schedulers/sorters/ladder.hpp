@@ -0,0 +1,538 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/sorters/heapPEL.hpp>
+#include <magnet/exception.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cmath>
+
+namespace dynamo {
+  template<size_t Size>
+  class PELMinMax;
+
+  template<size_t Size>
+  class PELInline;
+
+  class PELSingleEvent;
+
+  template<class T> struct FELLadderName;
+
+  template<>
+  struct FELLadderName<PELHeap>
+  {
+    inline static std::string name() { return "Ladder"; }
+  };
+
+  template<size_t I>
+  struct FELLadderName<PELMinMax<I> >
+  {
+    inline static std::string name() { return std::string("LadderMinMax") + boost::lexical_cast<std::string>(I); }
+  };
+
+  template<size_t I>
+  struct FELLadderName<PELInline<I> >
+  {
+    inline static std::string name() { return std::string("LadderInline") + boost::lexical_cast<std::string>(I); }
+  };
+
+  template<>
+  struct FELLadderName<PELSingleEvent>
+  {
+    inline static std::string name() { return "LadderSingleEvent"; }
+  };
+
+  /*! \brief An adaptive ladder queue FEL.
+
+    This is an implementation of the Ladder Queue of Tang, Goh and
+    Thng (ACM TOMACS 15, 175, 2005). The PELs are sorted using their
+    next event time, which is stored in one of three structures:
+
+    - The Top: an unsorted list of all PELs whose event times are
+      later than the range covered by the ladder.
+
+    - The Ladder: a stack of rungs of buckets. Each bucket holds an
+      unsorted list of PELs within its time range. When a bucket holds
+      too many PELs to sort cheaply, it is split into a new rung of
+      finer buckets. The bucket widths are therefore set by the
+      local density of events, rather than once at initialisation as
+      in the FELBoundedPQ.
+
+    - The Bottom: a short sorted list of the earliest PELs.
+
+    When the Bottom is exhausted, the next non-empty bucket of the
+    lowest rung is sorted into it (or split into a new rung). When the
+    Ladder is exhausted the Top is spread over a new first rung. Each
+    PEL is moved a bounded number of times between these structures,
+    giving O(1) amortised insertion and removal.
+
+    This is a better choice than the FELBoundedPQ when the
+    distribution of event times is very inhomogeneous (e.g., granular
+    systems under gravity).
+  */
+  template<typename T = PELHeap>
+  class FELLadder: public FEL
+  {
+    //! \brief Location markers for PELs not stored in a rung.
+    enum { TOP = -1, BOTTOM = -2, INFINITE = -3 };
+
+    //! \brief The maximum number of PELs in a bucket before it is split into a new rung.
+    static const size_t _threshold = 50;
+    //! \brief The maximum number of rungs in the ladder.
+    static const size_t _maxRungs = 8;
+
+    struct Entry
+    {
+      T data;
+      double key;
+      int next;
+      int previous;
+      int rung;
+      size_t bucket;
+    };
+
+    struct Rung
+    {
+      double start;
+      double width;
+      size_t current;
+      std::vector<int> heads;
+      std::vector<size_t> counts;
+
+      inline double currentStart() const { return start + current * width; }
+
+      inline size_t getBucket(const double key) const
+      {
+	const double fbucket = (key - start) / width;
+	size_t bucket = (fbucket > 0) ? size_t(fbucket) : 0;
+	//Guard against rounding errors
+	bucket = std::min(bucket, heads.size() - 1);
+	return std::max(bucket, current);
+      }
+    };
+
+    std::vector<Entry> _entries;
+    std::vector<Rung> _rungs;
+    size_t _nRungs;
+
+    int _topHead;
+    double _topStart;
+    int _bottomHead;
+    size_t _bottomCount;
+    int _infHead;
+
+    double pecTime;
+
+  public:
+    FELLadder() { clear(); }
+
+    void resize(const size_t& a)
+    {
+      clear();
+      _entries.resize(a);
+      //Until the first call to init(), every PEL is empty
+      for (size_t i(0); i < _entries.size(); ++i)
+	{
+	  _entries[i].rung = INFINITE;
+	  _entries[i].key = HUGE_VAL;
+	  linkFront(_infHead, i);
+	}
+    }
+
+    void clear()
+    {
+      _entries.clear();
+      _rungs.clear();
+      _rungs.resize(_maxRungs);
+      pecTime = 0.0;
+      resetLadder();
+    }
+
+    void init()
+    {
+      resetLadder();
+      for (size_t i(0); i < _entries.size(); ++i)
+	insert(i);
+      orderNextEvent();
+    }
+
+    void rebuild() { init(); }
+
+    inline void stream(const double& ndt) { pecTime += ndt; }
+
+    inline void push(const Event& tmpVal, const size_t& pID)
+    {
+#ifdef DYNAMO_DEBUG
+      if (std::isnan(tmpVal.dt))
+	M_throw() << "NaN value pushed into the sorter! Should be Inf I guess?";
+#endif
+
+      tmpVal.dt += pecTime;
+      _entries[pID].data.push(tmpVal);
+    }
+
+    inline void update(const size_t& pID)
+    {
+      remove(pID);
+      insert(pID);
+    }
+
+    inline void clearPEL(const size_t& ID) { _entries[ID].data.clear(); }
+    inline void popNextPELEvent(const size_t& ID) { _entries[ID].data.pop(); }
+    inline void popNextEvent() { _entries[next_ID()].data.pop(); }
+    virtual bool empty() const { return _entries[next_ID()].data.empty(); }
+
+    virtual std::pair<size_t, Event> next() const
+    {
+      const size_t ID = next_ID();
+      Event nextevent = _entries[ID].data.top();
+      nextevent.dt -= pecTime;
+      return std::pair<size_t, Event>(ID, nextevent);
+    }
+
+    inline void sort() { orderNextEvent(); }
+
+    inline void rescaleTimes(const double& factor)
+    {
+      for (Entry& entry : _entries)
+	entry.data.rescaleTimes(factor);
+      pecTime *= factor;
+      init();
+    }
+
+  private:
+    /*! \brief The ID of the PEL holding the next event.
+
+      This is only valid after a call to orderNextEvent(). If only
+      PELs without any finite events remain, one of those is returned.
+     */
+    inline size_t next_ID() const
+    { return (_bottomHead != -1) ? _bottomHead : _infHead; }
+
+    void resetLadder()
+    {
+      _nRungs = 0;
+      _topHead = -1;
+      _topStart = -HUGE_VAL;
+      _bottomHead = -1;
+      _bottomCount = 0;
+      _infHead = -1;
+    }
+
+    inline void linkFront(int& head, const int e)
+    {
+      _entries[e].previous = -1;
+      _entries[e].next = head;
+      if (head != -1)
+	_entries[head].previous = e;
+      head = e;
+    }
+
+    inline void unlink(int& head, const int e)
+    {
+      const int prev = _entries[e].previous, next = _entries[e].next;
+      if (prev == -1)
+	head = next;
+      else
+	_entries[prev].next = next;
+
+      if (next != -1)
+	_entries[next].previous = prev;
+    }
+
+    inline void insertInRung(const size_t r, const int e)
+    {
+      Rung& rung = _rungs[r];
+      const size_t bucket = rung.getBucket(_entries[e].key);
+      _entries[e].rung = r;
+      _entries[e].bucket = bucket;
+      linkFront(rung.heads[bucket], e);
+      ++rung.counts[bucket];
+    }
+
+    inline void insert(const int e)
+    {
+      const double key = _entries[e].data.getdt();
+      _entries[e].key = key;
+
+      //PELs without any finite events (this also catches NaN's)
+      if (!(key < HUGE_VAL))
+	{
+	  _entries[e].rung = INFINITE;
+	  linkFront(_infHead, e);
+	  return;
+	}
+
+      if (key >= _topStart)
+	{
+	  _entries[e].rung = TOP;
+	  linkFront(_topHead, e);
+	  return;
+	}
+
+      //Find the highest rung which still covers this time. Exhausted
+      //rungs are skipped, their ranges are already covered by the
+      //rungs below.
+      for (size_t r(0); r < _nRungs; ++r)
+	if ((_rungs[r].current < _rungs[r].heads.size()) && (key >= _rungs[r].currentStart()))
+	  {
+	    insertInRung(r, e);
+	    return;
+	  }
+
+      insertInBottom(e);
+    }
+
+    inline void insertInBottom(const int e)
+    {
+      //If the Bottom has become too long to be sorted by insertion,
+      //spread it over a new rung.
+      if ((_bottomCount > 2 * _threshold) && (_nRungs < _maxRungs))
+	bottomToRung();
+
+      _entries[e].rung = BOTTOM;
+      ++_bottomCount;
+      const double key = _entries[e].key;
+
+      if ((_bottomHead == -1) || (key < _entries[_bottomHead].key))
+	{
+	  linkFront(_bottomHead, e);
+	  return;
+	}
+
+      int prev = _bottomHead;
+      while ((_entries[prev].next != -1) && (_entries[_entries[prev].next].key <= key))
+	prev = _entries[prev].next;
+
+      _entries[e].previous = prev;
+      _entries[e].next = _entries[prev].next;
+      if (_entries[prev].next != -1)
+	_entries[_entries[prev].next].previous = e;
+      _entries[prev].next = e;
+    }
+
+    inline void remove(const int e)
+    {
+      switch (_entries[e].rung)
+	{
+	case TOP: unlink(_topHead, e); break;
+	case INFINITE: unlink(_infHead, e); break;
+	case BOTTOM: unlink(_bottomHead, e); --_bottomCount; break;
+	default:
+	  {
+	    Rung& rung = _rungs[_entries[e].rung];
+	    unlink(rung.heads[_entries[e].bucket], e);
+	    --rung.counts[_entries[e].bucket];
+	  }
+	}
+    }
+
+    /*! \brief Create a new rung of buckets at the bottom of the
+        ladder, returning its index.
+     */
+    inline size_t newRung(const double start, const double width, const size_t nbuckets)
+    {
+      Rung& rung = _rungs[_nRungs];
+      rung.start = start;
+      rung.width = width;
+      rung.current = 0;
+      rung.heads.assign(nbuckets, -1);
+      rung.counts.assign(nbuckets, 0);
+      return _nRungs++;
+    }
+
+    /*! \brief Spread the PELs of the Bottom over a new rung.
+     */
+    void bottomToRung()
+    {
+      double minVal = HUGE_VAL, maxVal = -HUGE_VAL;
+      for (int e = _bottomHead; e != -1; e = _entries[e].next)
+	{
+	  minVal = std::min(minVal, _entries[e].key);
+	  maxVal = std::max(maxVal, _entries[e].key);
+	}
+
+      const double width = (maxVal - minVal) / _bottomCount;
+      //All the events are (numerically) simultaneous
+      if (!(minVal + width > minVal)) return;
+
+      const size_t r = newRung(minVal, width, _bottomCount);
+      for (int e = _bottomHead; e != -1;)
+	{
+	  const int next = _entries[e].next;
+	  insertInRung(r, e);
+	  e = next;
+	}
+
+      _bottomHead = -1;
+      _bottomCount = 0;
+    }
+
+    /*! \brief Sort the contents of a bucket into the (empty) Bottom.
+     */
+    void bucketToBottom(Rung& rung, const size_t bucket)
+    {
+      std::vector<int> ids;
+      ids.reserve(rung.counts[bucket]);
+      for (int e = rung.heads[bucket]; e != -1; e = _entries[e].next)
+	ids.push_back(e);
+
+      std::sort(ids.begin(), ids.end(), [&](const int a, const int b) { return _entries[a].key < _entries[b].key; });
+
+      for (auto it = ids.rbegin(); it != ids.rend(); ++it)
+	{
+	  _entries[*it].rung = BOTTOM;
+	  linkFront(_bottomHead, *it);
+	}
+      _bottomCount = ids.size();
+
+      rung.heads[bucket] = -1;
+      rung.counts[bucket] = 0;
+      rung.current = bucket + 1;
+    }
+
+    /*! \brief Spread the contents of a bucket over a new finer rung.
+     */
+    void bucketToRung(const size_t r, const size_t bucket)
+    {
+      Rung& parent = _rungs[r];
+      const size_t count = parent.counts[bucket];
+      const double start = parent.start + bucket * parent.width;
+      const double width = parent.width / count;
+
+      //The bucket is too narrow to split further
+      if (!(start + width > start))
+	{
+	  bucketToBottom(parent, bucket);
+	  return;
+	}
+
+      int e = parent.heads[bucket];
+      parent.heads[bucket] = -1;
+      parent.counts[bucket] = 0;
+      parent.current = bucket + 1;
+
+      const size_t child = newRung(start, width, count);
+      while (e != -1)
+	{
+	  const int next = _entries[e].next;
+	  insertInRung(child, e);
+	  e = next;
+	}
+    }
+
+    /*! \brief Spread the Top over the first rung of the (empty) ladder.
+     */
+    void topToRung()
+    {
+      //Every finite event is in the Top, so this is an opportunity to
+      //reset the peculiar time of the FEL.
+      if (pecTime != 0)
+	{
+	  for (Entry& entry : _entries)
+	    entry.data.stream(pecTime);
+	  pecTime = 0;
+	}
+
+      std::vector<double> keys;
+      for (int e = _topHead; e != -1; e = _entries[e].next)
+	keys.push_back(_entries[e].data.getdt());
+
+      const size_t count = keys.size();
+      const double minVal = *std::min_element(keys.begin(), keys.end());
+      const double maxVal = *std::max_element(keys.begin(), keys.end());
+
+      //The rung is sized using the median event time, as a few
+      //events may be scheduled at extremely late times (e.g., system
+      //events which will "never" occur). These would otherwise
+      //stretch the rung until every other event fell into its first
+      //bucket. Events beyond the end of the rung remain in the Top.
+      std::nth_element(keys.begin(), keys.begin() + count / 2, keys.end());
+      double width = 2 * (keys[count / 2] - minVal) / count;
+      if (!(minVal + width > minVal))
+	width = (maxVal - minVal) / count;
+
+      int e = _topHead;
+      _topHead = -1;
+
+      if ((count <= _threshold) || !(minVal + width > minVal))
+	{
+	  //Few or simultaneous events, just sort them into the Bottom
+	  _topStart = maxVal;
+	  while (e != -1)
+	    {
+	      const int next = _entries[e].next;
+	      _entries[e].key = _entries[e].data.getdt();
+	      insertInBottom(e);
+	      e = next;
+	    }
+	  return;
+	}
+
+      _topStart = std::min(minVal + count * width, maxVal);
+      newRung(minVal, width, count);
+      while (e != -1)
+	{
+	  const int next = _entries[e].next;
+	  insert(e);
+	  e = next;
+	}
+    }
+
+    /*! \brief Makes sure the next event is at the head of the Bottom.
+     */
+    void orderNextEvent()
+    {
+      while (_bottomHead == -1)
+	{
+	  if (!_nRungs)
+	    {
+	      //Only PELs without finite events remain
+	      if (_topHead == -1) return;
+	      topToRung();
+	      continue;
+	    }
+
+	  const size_t r = _nRungs - 1;
+	  Rung& rung = _rungs[r];
+	  while ((rung.current < rung.heads.size()) && (rung.heads[rung.current] == -1))
+	    ++rung.current;
+
+	  if (rung.current == rung.heads.size())
+	    {
+	      //This rung is exhausted
+	      --_nRungs;
+	      continue;
+	    }
+
+	  if ((rung.counts[rung.current] > _threshold) && (_nRungs < _maxRungs))
+	    bucketToRung(r, rung.current);
+	  else
+	    bucketToBottom(rung, rung.current);
+	}
+    }
+
+    virtual void outputXML(magnet::xml::XmlStream& XML) const
+    { XML << magnet::xml::attr("Type") << FELLadderName<T>::name(); }
+  };
+}
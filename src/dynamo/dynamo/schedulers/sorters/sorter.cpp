@@ -42,6 +42,18 @@ namespace dynamo {
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<7> >());
     if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<8> >::name())
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<8> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELInline<4> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELInline<4> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELInline<8> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELInline<8> >());
+    if (std::string(XML.getAttribute("Type")) == FELLadderName<PELHeap>::name())
+      return shared_ptr<FEL>(new FELLadder<>());
+    if (std::string(XML.getAttribute("Type")) == FELLadderName<PELSingleEvent>::name())
+      return shared_ptr<FEL>(new FELLadder<PELSingleEvent>());
+    if (std::string(XML.getAttribute("Type")) == FELLadderName<PELMinMax<3> >::name())
+      return shared_ptr<FEL>(new FELLadder<PELMinMax<3> >());
+    if (std::string(XML.getAttribute("Type")) == FELLadderName<PELInline<8> >::name())
+      return shared_ptr<FEL>(new FELLadder<PELInline<8> >());
     else if (std::string(XML.getAttribute("Type")) == std::string("CBT"))
       return shared_ptr<FEL>(new FELCBT());
     else 
@@ -41,6 +41,14 @@ namespace dynamo {
     virtual bool   empty() const = 0;
     virtual void   rebuild() = 0;
     virtual void   stream(const double&) = 0;
+
+    /*! \brief Adds an Event to the PEL of a particle.
+
+      Implementations must only modify the PEL of the passed particle
+      ID, as the Scheduler may push into the PELs of different
+      particles concurrently (see Scheduler::rebuildListConcurrently).
+      The FEL is not reordered until update() is called.
+     */
     virtual void   push(const Event&, const size_t&) = 0;
     virtual void   update(const size_t&) = 0;
     virtual std::pair<size_t, Event> next() const = 0;
@@ -29,14 +29,22 @@
 #include <dynamo/interactions/interaction.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/globals/PBCSentinel.hpp>
+#include <dynamo/interactions/captures.hpp>
+#include <dynamo/binaryconfig.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/chain.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <magnet/compression/bzip2.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/math/dilated_int.hpp>
 #include <dynamo/BC/BC.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <set>
 
@@ -52,8 +60,10 @@ namespace dynamo
     endEventCount(100000),
     eventPrintInterval(50000),
     nextPrintEvent(0),
+    particleSortInterval(0),
     primaryCellSize(1,1,1),
     ranGenerator(std::random_device()()),
+    threadPool(NULL),
     lastRunMFT(0.0),
     simID(0),
     replexExchangeNumber(0),
@@ -74,6 +84,36 @@ namespace dynamo
 	return (*lhs) < (*rhs);
       }
     };
+
+    /*! \brief Moves the capture maps of the ICapture interactions out
+        of their XML output for the lifetime of this object.
+
+      The capture maps are restored to the XML even if an exception
+      is thrown while the binary file is being written.
+     */
+    struct BinaryCaptureMaps
+    {
+      BinaryCaptureMaps(Simulation& sim): _sim(sim)
+      { setXMLCaptureMap(false); }
+
+      ~BinaryCaptureMaps() { setXMLCaptureMap(true); }
+
+      void setXMLCaptureMap(bool enable)
+      {
+	for (shared_ptr<Interaction>& ptr : _sim.interactions)
+	  if (std::dynamic_pointer_cast<ICapture>(ptr))
+	    std::dynamic_pointer_cast<ICapture>(ptr)->setXMLCaptureMap(enable);
+      }
+
+      Simulation& _sim;
+    };
+  }
+
+  Simulation::~Simulation()
+  {
+    try { waitForTickers(); }
+    catch (std::exception& err)
+      { derr << "A ticker plugin failed:\n" << err.what() << std::endl; }
   }
 
   void
@@ -81,6 +121,7 @@ namespace dynamo
   {
     if (status != INITIALISED)
       M_throw() << "Cannot reinitialise an un-initialised simulation";
+    waitForTickers();
     status = START;
     outputPlugins.clear();
     dynamics->updateAllParticles();
@@ -95,6 +136,8 @@ namespace dynamo
   {
     if (status != START)
       M_throw() << "Sim initialised at wrong time";
+
+    _interactionTable.clear();
     
     for (shared_ptr<Species>& ptr : species)
       ptr->initialise();
@@ -135,6 +178,8 @@ namespace dynamo
 
     status = SPECIES_INIT;
 
+    buildInteractionTable();
+
     dout << "Validating self-Interaction definitions" << std::endl;
     //Check that each particle has a representative interaction
     for (const Particle& particle : particles)
@@ -246,18 +291,13 @@ namespace dynamo
     status = OUTPUTPLUGIN_INIT;
 
     _nextPrint = eventCount + eventPrintInterval;
+    _nextParticleSort = eventCount + particleSortInterval;
     status = INITIALISED;
   }
 
   IntEvent 
   Simulation::getEvent(const Particle& p1, const Particle& p2) const
-  {
-    for (const shared_ptr<Interaction>& ptr : interactions)
-      if (ptr->isInteraction(p1,p2))
-	return ptr->getEvent(p1,p2);
-    
-    M_throw() << "Could not find the right interaction to test for";
-  }
+  { return getInteraction(p1, p2)->getEvent(p1, p2); }
 
   void 
   Simulation::stream(const double dt)
@@ -285,13 +325,71 @@ namespace dynamo
   const shared_ptr<Interaction>&
   Simulation::getInteraction(const Particle& p1, const Particle& p2) const 
   {
-    for (const shared_ptr<Interaction>& ptr : interactions)
-      if (ptr->isInteraction(p1,p2))
-	return ptr;
+    if (_interactionTable.empty())
+      {
+	for (const shared_ptr<Interaction>& ptr : interactions)
+	  if (ptr->isInteraction(p1,p2))
+	    return ptr;
+      }
+    else
+      {
+	const InteractionCandidates& entry 
+	  = _interactionTable[_particleSpecies[p1.getID()] * species.size() + _particleSpecies[p2.getID()]];
+	
+	const size_t tested = entry.IDs.size() - entry.covered;
+	for (size_t i(0); i < tested; ++i)
+	  if (interactions[entry.IDs[i]]->isInteraction(p1, p2))
+	    return interactions[entry.IDs[i]];
+	
+	if (entry.covered)
+	  return interactions[entry.IDs.back()];
+      }
   
     M_throw() << "Could not find an Interaction between particles " << p1.getID() << " and " << p2.getID() << ". All particle pairings must have a corresponding Interaction defined.";
   }
 
+  void
+  Simulation::buildInteractionTable()
+  {
+    dout << "Building the Interaction dispatch table" << std::endl;
+
+    _particleSpecies.resize(N());
+    for (size_t s(0); s < species.size(); ++s)
+      for (const size_t ID : *species[s]->getRange())
+	_particleSpecies[ID] = s;
+
+    std::vector<InteractionCandidates> table(species.size() * species.size());
+    size_t tested = 0;
+    for (size_t s1(0); s1 < species.size(); ++s1)
+      for (size_t s2(0); s2 < species.size(); ++s2)
+	{
+	  InteractionCandidates& entry = table[s1 * species.size() + s2];
+	  entry.covered = false;
+	  //The Interaction IDs are not yet assigned, but they will
+	  //match their position in the container
+	  for (size_t ID(0); ID < interactions.size(); ++ID)
+	    {
+	      const IDPairRange::PairCoverage coverage 
+		= interactions[ID]->getRange()->getCoverage(*this, *species[s1]->getRange(), *species[s2]->getRange());
+
+	      if (coverage == IDPairRange::NO_PAIRS) continue;
+
+	      entry.IDs.push_back(ID);
+	      if (coverage == IDPairRange::ALL_PAIRS)
+		{
+		  entry.covered = true;
+		  break;
+		}
+	    }
+	  tested += entry.IDs.size() - entry.covered;
+	}
+
+    dout << "Species pairs = " << table.size() 
+	 << ", Interactions tested per pair = " << double(tested) / table.size() << std::endl;
+
+    _interactionTable.swap(table);
+  }
+
   const shared_ptr<Species>& 
   Simulation::SpeciesContainer::operator()(const Particle& p1) const 
   {
@@ -338,18 +436,34 @@ namespace dynamo
     if (!boost::filesystem::exists(fileName))
       M_throw() << "Could not find the XML file named " << fileName
 		<< "\nPlease check the file exists.";
+
+    //Binary configuration files store the XML uncompressed at the
+    //start of the file, followed by the particle data blocks.
+    std::unique_ptr<binary::Reader> binaryFile;
+    if (binary::isBinaryFile(fileName))
+      {
+	binaryFile.reset(new binary::Reader(fileName));
+	doc.getStoredXMLData() = binaryFile->getXML();
+      }
+    else if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
+      {
+	//Compressed files are decompressed using the thread pool (if
+	//available), as they may contain multiple bzip2 streams.
+	magnet::thread::ThreadPool serialPool;
+	io::mapped_file_source inputFile(fileName);
+	magnet::compression::bzip2_parallel_decompress(inputFile.data(), inputFile.size(), doc.getStoredXMLData(), 
+						       threadPool ? *threadPool : serialPool);
+      }
+    else
     { //This scopes out the file objects
       
       //We use the boost iostreams library to load the file into a
-      //string which may be compressed.
+      //string.
       
       //We make our filtering iostream
       io::filtering_istream inputFile;
       
-      //Now check if we should add a decompressor filter
-      if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
-	inputFile.push(io::bzip2_decompressor());
-      else if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
+      if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
 	M_throw() << "Unrecognized extension for xml file";
 
       //Finally, add the file as a source
@@ -403,7 +517,10 @@ namespace dynamo
     
     BCs = BoundaryCondition::getClass(simNode.getNode("BC"), this);
     dynamics = Dynamics::getClass(simNode.getNode("Dynamics"), this);
-    dynamics->loadParticleXMLData(mainNode);
+    if (binaryFile)
+      loadParticleBinaryData(*binaryFile);
+    else
+      dynamics->loadParticleXMLData(mainNode);
 
     if (simNode.hasNode("Topology"))
       {
@@ -417,6 +534,11 @@ namespace dynamo
     for (magnet::xml::Node node = simNode.getNode("Interactions").fastGetNode("Interaction"); node.valid(); ++node)
       interactions.push_back(Interaction::getClass(node, this));
 
+    if (binaryFile)
+      for (shared_ptr<Interaction>& ptr : interactions)
+	if (std::dynamic_pointer_cast<ICapture>(ptr))
+	  std::dynamic_pointer_cast<ICapture>(ptr)->loadCaptureMap(*binaryFile);
+
     if (simNode.hasNode("Locals"))
       {
 	checkNodeNameAttribute(simNode.getNode("Locals").fastGetNode("Local"));
@@ -454,16 +576,78 @@ namespace dynamo
   void
   Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round)
   {
+    if (binary::isBinaryFile(fileName))
+      {
+	writeBinaryFile(fileName, applyBC);
+	return;
+      }
+
     namespace io = boost::iostreams;
+    magnet::thread::ThreadPool serialPool;
     io::filtering_ostream coutputFile;
 
+    //Compressed files are written in blocks, which are compressed
+    //concurrently using the thread pool (if available).
     if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
-  
-    coutputFile.push(io::file_sink(fileName));
+      coutputFile.push(magnet::compression::bzip2_parallel_sink(fileName, threadPool ? *threadPool : serialPool));
+    else
+      coutputFile.push(io::file_sink(fileName));
   
     namespace xml = magnet::xml;
     xml::XmlStream XML(coutputFile);
+    writeConfigXML(XML, applyBC, round);
+
+    dout << "Config written to " << fileName << std::endl;
+  }
+
+  namespace {
+    /*! \brief An XmlStream into a string, which is kept open so that
+        the rest of the document can be written later.
+     */
+    struct DeferredXML
+    {
+      DeferredXML(): XML(stream) { stream.push(boost::iostreams::back_inserter(data)); }
+
+      std::string data;
+      boost::iostreams::filtering_ostream stream;
+      magnet::xml::XmlStream XML;
+    };
+  }
+
+  std::function<std::string()>
+  Simulation::getDeferredConfigXML(bool applyBC, bool round)
+  {
+    shared_ptr<DeferredXML> deferred(new DeferredXML);
+    deferred->XML.setFormatXML(true);
+
+    dynamics->updateAllParticles();
+
+    //Rescale the properties to the configuration file units
+    _properties.rescaleUnit(Property::Units::L, 1.0 / units.unitLength());
+    _properties.rescaleUnit(Property::Units::T, 1.0 / units.unitTime());
+    _properties.rescaleUnit(Property::Units::M, 1.0 / units.unitMass());
+
+    deferred->XML << std::setprecision(std::numeric_limits<double>::digits10 + 2 - 4 * round);
+    outputConfigHeadXML(deferred->XML);
+    const std::function<void(magnet::xml::XmlStream&)> particleData = dynamics->copyParticleXMLData(applyBC);
+
+    //Rescale the properties back to the simulation units
+    _properties.rescaleUnit(Property::Units::L, units.unitLength());
+    _properties.rescaleUnit(Property::Units::T, units.unitTime());
+    _properties.rescaleUnit(Property::Units::M, units.unitMass());
+
+    return [deferred, particleData]() {
+      particleData(deferred->XML);
+      deferred->XML << magnet::xml::endtag("DynamOconfig");
+      //Flush the stream into the string
+      deferred->stream.reset();
+      return std::move(deferred->data);
+    };
+  }
+
+  void
+  Simulation::writeConfigXML(magnet::xml::XmlStream& XML, bool applyBC, bool round)
+  {
     XML.setFormatXML(true);
 
     dynamics->updateAllParticles();
@@ -473,8 +657,41 @@ namespace dynamo
     _properties.rescaleUnit(Property::Units::T, 1.0 / units.unitTime());
     _properties.rescaleUnit(Property::Units::M, 1.0 / units.unitMass());
     
-    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2 - 4 * round)
-	<< xml::prolog()
+    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2 - 4 * round);
+    outputConfigXML(XML, applyBC, true);
+
+    //Rescale the properties back to the simulation units
+    _properties.rescaleUnit(Property::Units::L, units.unitLength());
+    _properties.rescaleUnit(Property::Units::T, units.unitTime());
+    _properties.rescaleUnit(Property::Units::M, units.unitMass());
+  }
+
+  void
+  Simulation::outputConfigXML(magnet::xml::XmlStream& XML, bool applyBC, bool particleData) const
+  {
+    namespace xml = magnet::xml;
+
+    outputConfigHeadXML(XML);
+
+    if (particleData)
+      dynamics->outputParticleXMLData(XML, applyBC);
+    else
+      {
+	XML << xml::tag("ParticleData");
+	if (dynamics->hasOrientationData())
+	  XML << xml::attr("OrientationData") << "Y";
+	XML << xml::endtag("ParticleData");
+      }
+
+    XML << xml::endtag("DynamOconfig");
+  }
+
+  void
+  Simulation::outputConfigHeadXML(magnet::xml::XmlStream& XML) const
+  {
+    namespace xml = magnet::xml;
+
+    XML << xml::prolog()
 	<< xml::tag("DynamOconfig")
 	<< xml::attr("version") << configFileVersion
 	<< xml::tag("Simulation");
@@ -545,10 +762,79 @@ namespace dynamo
 	<< xml::endtag("Dynamics")
 	<< xml::endtag("Simulation")
 	<< _properties;
+  }
 
-    dynamics->outputParticleXMLData(XML, applyBC);
+  void
+  Simulation::writeBinaryFile(std::string fileName, bool applyBC)
+  {
+    namespace io = boost::iostreams;
+    namespace xml = magnet::xml;
 
-    XML << xml::endtag("DynamOconfig");
+    dynamics->updateAllParticles();
+
+    //Rescale the properties to the configuration file units
+    _properties.rescaleUnit(Property::Units::L, 1.0 / units.unitLength());
+    _properties.rescaleUnit(Property::Units::T, 1.0 / units.unitTime());
+    _properties.rescaleUnit(Property::Units::M, 1.0 / units.unitMass());
+
+    //The capture maps are stored in their own blocks
+    BinaryCaptureMaps captureMaps(*this);
+
+    std::string xmlData;
+    {
+      io::filtering_ostream xmlStream;
+      xmlStream.push(io::back_inserter(xmlData));
+      xml::XmlStream XML(xmlStream);
+      XML.setFormatXML(true);
+      XML << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+      outputConfigXML(XML, applyBC, false);
+    }
+
+    binary::Writer file;
+    binary::ParticleRecord* record = file.addBlock<binary::ParticleRecord>(binary::PARTICLES, "", N());
+    for (const Particle& particle : particles)
+      {
+	Particle tmp(particle);
+	if (applyBC)
+	  BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
+
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    record->position[iDim] = tmp.getPosition()[iDim] / units.unitLength();
+	    record->velocity[iDim] = tmp.getVelocity()[iDim] / units.unitVelocity();
+	  }
+	record->ID = tmp.getID();
+	record->dynamic = tmp.testState(Particle::DYNAMIC);
+	++record;
+      }
+
+    if (dynamics->hasOrientationData())
+      {
+	binary::OrientationRecord* orientation = file.addBlock<binary::OrientationRecord>(binary::ORIENTATIONS, "", N());
+	for (const Dynamics::rotData& data : static_cast<const Dynamics&>(*dynamics).getCompleteRotData())
+	  {
+	    orientation->orientation[0] = data.orientation.real();
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      {
+		orientation->orientation[iDim + 1] = data.orientation.imaginary()[iDim];
+		orientation->angularVelocity[iDim] = data.angularVelocity[iDim];
+	      }
+	    ++orientation;
+	  }
+      }
+
+    for (const shared_ptr<Property>& property : _properties)
+      if (std::dynamic_pointer_cast<ParticleProperty>(property))
+	{
+	  const std::vector<double>& values = std::dynamic_pointer_cast<ParticleProperty>(property)->getValues();
+	  std::copy(values.begin(), values.end(), file.addBlock<double>(binary::PROPERTY, property->getName(), values.size()));
+	}
+
+    for (shared_ptr<Interaction>& ptr : interactions)
+      if (std::dynamic_pointer_cast<ICapture>(ptr))
+	std::dynamic_pointer_cast<ICapture>(ptr)->outputCaptureMap(file);
+
+    file.write(fileName, xmlData, N());
 
     dout << "Config written to " << fileName << std::endl;
 
@@ -557,10 +843,79 @@ namespace dynamo
     _properties.rescaleUnit(Property::Units::T, units.unitTime());
     _properties.rescaleUnit(Property::Units::M, units.unitMass());
   }
-  
+
+  void
+  Simulation::loadParticleBinaryData(const binary::Reader& file)
+  {
+    dout << "Loading Particle Data" << std::endl;
+
+    const binary::Reader::Block* block = file.find(binary::PARTICLES);
+    if (!block || (block->count<binary::ParticleRecord>() != file.N()))
+      M_throw() << "The binary configuration file is missing its particle data";
+
+    particles.reserve(file.N());
+    for (const binary::ParticleRecord* record = block->begin<binary::ParticleRecord>();
+	 record != block->end<binary::ParticleRecord>(); ++record)
+      {
+	Vector pos, vel;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    pos[iDim] = record->position[iDim] * units.unitLength();
+	    vel[iDim] = record->velocity[iDim] * units.unitVelocity();
+	  }
+
+	//The particles are written in order of their ID
+	if (record->ID != particles.size())
+	  M_throw() << "The binary configuration file has particle ID " << record->ID
+		    << " stored at position " << particles.size();
+
+	Particle part(pos, vel, particles.size());
+	if (!record->dynamic) part.clearState(Particle::DYNAMIC);
+	particles.push_back(part);
+      }
+
+    dout << "Particle count " << N() << std::endl;
+
+    block = file.find(binary::ORIENTATIONS);
+    if (block)
+      {
+	if (block->count<binary::OrientationRecord>() != N())
+	  M_throw() << "The binary configuration file has the wrong number of orientations";
+
+	std::vector<Dynamics::rotData>& rotData = dynamics->getCompleteRotData();
+	rotData.resize(N());
+	const binary::OrientationRecord* record = block->begin<binary::OrientationRecord>();
+	for (size_t i(0); i < N(); ++i, ++record)
+	  {
+	    Vector imaginary;
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      {
+		imaginary[iDim] = record->orientation[iDim + 1];
+		rotData[i].angularVelocity[iDim] = record->angularVelocity[iDim];
+	      }
+	    rotData[i].orientation = Quaternion(record->orientation[0], imaginary);
+	  }
+      }
+
+    for (const shared_ptr<Property>& property : _properties)
+      if (std::dynamic_pointer_cast<ParticleProperty>(property))
+	{
+	  block = file.find(binary::PROPERTY, property->getName());
+	  if (!block || (block->count<double>() != N()))
+	    M_throw() << "The binary configuration file is missing the data for the \""
+		      << property->getName() << "\" Property";
+
+	  std::dynamic_pointer_cast<ParticleProperty>(property)->getValues()
+	    .assign(block->begin<double>(), block->end<double>());
+	}
+  }
+
   void 
   Simulation::replexerSwap(Simulation& other)
   {
+    waitForTickers();
+    other.waitForTickers();
+
     //Get all particles up to date and zero the pecTimes
     dynamics->updateAllParticles();
     other.dynamics->updateAllParticles();
@@ -690,7 +1045,7 @@ namespace dynamo
     dynamics->updateAllParticles();
 
     size_t errors = 0;
-    std::vector<Particle>::const_iterator iPtr1, iPtr2;
+    ParticleList::const_iterator iPtr1, iPtr2;
   
     for (const shared_ptr<Interaction>& interaction_ptr : interactions)
       {
@@ -711,6 +1066,41 @@ namespace dynamo
     return errors;
   }
 
+  void
+  Simulation::sortParticles()
+  {
+    //The primary image is divided into 2^10 cells in each dimension
+    //(the most that fit a 32 bit Morton key)
+    const size_t bits = 10;
+    const size_t cells = size_t(1) << bits;
+
+    std::vector<std::pair<uint32_t, size_t> > keys;
+    keys.reserve(N());
+    for (const Particle& part : particles)
+      {
+	Vector pos = part.getPosition();
+	BCs->applyBC(pos);
+
+	uint32_t key = 0;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    const long coord = std::floor((pos[iDim] / primaryCellSize[iDim] + 0.5) * cells);
+	    const size_t clamped = std::min(size_t(std::max(coord, long(0))), cells - 1);
+	    key |= magnet::math::DilatedInteger<3>(clamped).getDilatedValue() << iDim;
+	  }
+	keys.push_back(std::make_pair(key, size_t(part.getID())));
+      }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<size_t> order;
+    order.reserve(N());
+    for (const auto& key : keys)
+      order.push_back(key.second);
+
+    particles.reorder(order);
+  }
+
   void
   Simulation::outputData(std::string filename)
   {
@@ -725,9 +1115,36 @@ namespace dynamo
   
     coutputFile.push(io::file_sink(filename));
     
+    magnet::xml::XmlStream XML(coutputFile);
+    outputDataXML(XML);
+
+    dout << "Output written to " << filename << std::endl;
+  }
+
+  std::string
+  Simulation::getOutputDataXML()
+  {
+    if (status < INITIALISED)
+      M_throw() << "Cannot output data when not initialised!";
+
+    namespace io = boost::iostreams;
+    std::string data;
+    {
+      io::filtering_ostream stream;
+      stream.push(io::back_inserter(data));
+      magnet::xml::XmlStream XML(stream);
+      outputDataXML(XML);
+    }
+    return data;
+  }
+
+  void
+  Simulation::outputDataXML(magnet::xml::XmlStream& XML)
+  {
     namespace xml = magnet::xml;
-    xml::XmlStream XML(coutputFile);
     XML.setFormatXML(true);
+
+    waitForTickers();
     
     XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
 	<< xml::prolog() << xml::tag("OutputData");
@@ -745,9 +1162,11 @@ namespace dynamo
     for (shared_ptr<System> & Ptr : systems)
       Ptr->outputData(XML);
 
-    XML << xml::endtag("OutputData");
+#ifdef DYNAMO_PROFILE
+    ptrScheduler->getProfiler().outputXML(XML, *this);
+#endif
 
-    dout << "Output written to " << filename << std::endl;
+    XML << xml::endtag("OutputData");
   }
 
   void 
@@ -770,6 +1189,26 @@ namespace dynamo
     ptr->setTickerPeriod(nP * ptr->getPeriod());
   }
 
+  void
+  Simulation::setTickerAsync(bool async)
+  {
+    shared_ptr<SysTicker> ptr = std::dynamic_pointer_cast<SysTicker>(systems["SystemTicker"]);
+    if (!ptr)
+      M_throw() << "Could not find system ticker (maybe not required?)";
+
+    ptr->setAsync(async);
+  }
+
+  void
+  Simulation::waitForTickers()
+  {
+    auto it = systems.find("SystemTicker");
+    if (it == systems.end()) return;
+
+    shared_ptr<SysTicker> ptr = std::dynamic_pointer_cast<SysTicker>(*it);
+    if (ptr) ptr->waitForTickers();
+  }
+
   void 
   Simulation::addOutputPlugin(std::string Name)
   {
@@ -797,9 +1236,16 @@ namespace dynamo
 	ptrScheduler->runNextEvent();
 	
 	//Periodic work
+	if (particleSortInterval && (eventCount >= _nextParticleSort))
+	  {
+	    sortParticles();
+	    _nextParticleSort = eventCount + particleSortInterval;
+	  }
+
 	if ((eventCount >= _nextPrint) && !silentMode && outputPlugins.size())
 	  {
 	    //Print the screen data plugins
+	    waitForTickers();
 	    for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
 	      Ptr->periodicOutput();
 	    
@@ -22,9 +22,12 @@
 #include <dynamo/property.hpp>
 #include <dynamo/units/units.hpp>
 #include <magnet/function/delegate.hpp>
+#include <functional>
 #include <random>
 #include <vector>
 
+namespace magnet { namespace thread { class ThreadPool; } }
+
 namespace dynamo
 {  
   class Scheduler;
@@ -47,6 +50,7 @@ namespace dynamo
 
   class IDRange;
   class IDPairRange;
+  namespace binary { class Reader; }
 
 
   //! \brief Holds the different phases of the simulation initialisation
@@ -123,6 +127,9 @@ namespace dynamo
     /*! \brief Significant default value initialisation.
      */
     Simulation();
+
+    //! Waits for any ticker plugins still running in the background.
+    ~Simulation();
     
     /*! \brief Initialise the entire Simulation and the Simulation struct.
      
@@ -216,6 +223,17 @@ namespace dynamo
     */
     size_t checkSystem();
 
+    /*! \brief Reorders the storage of the particles (see
+        ParticleList::reorder()) along a Morton curve through the
+        primary image.
+
+      This places particles which are close in space close in
+      memory. As particles diffuse, this ordering decays, so it is
+      repeated every particleSortInterval events by
+      runSimulationStep().
+     */
+    void sortParticles();
+
     void addSystemTicker();
     
     double getSimVolume() const;
@@ -261,8 +279,9 @@ namespace dynamo
     /*! \brief Loads a Simulation from the passed XML file.
 
       \param filename The path to the XML file to load. The filename
-     must end in either ".xml" for uncompressed xml files or ".bz2"
-     for bzip2 compressed configuration files.
+     must end in either ".xml" for uncompressed xml files, ".bz2"
+     for bzip2 compressed configuration files, or ".bin" for binary
+     configuration files (see \ref binary).
     */
     void loadXMLfile(std::string filename);
     
@@ -270,8 +289,9 @@ namespace dynamo
 
       \param filename The path to the XML file to write (this file
       will either be created or overwritten). The filename must end in
-      either ".xml" for uncompressed xml files or ".bz2" for bzip2
-      compressed configuration files.
+      either ".xml" for uncompressed xml files, ".bz2" for bzip2
+      compressed configuration files, or ".bin" for binary
+      configuration files (see \ref binary).
 
       \param round If true, the data in the XML file will be written
       out at 2 s.f. lower precision to round all the values. This is
@@ -280,6 +300,25 @@ namespace dynamo
     */
     void writeXMLfile(std::string filename, bool applyBC = true, bool round = false);
 
+    /*! \brief Copies the Simulation configuration so that it can be
+      rendered to a string later.
+
+      The returned function renders the XML which \ref writeXMLfile
+      would have written at the time of this call. Only the (small)
+      description of the Simulation is rendered here, the particle
+      data is copied and formatted when the function is called. This
+      allows the slow formatting, compression and file output to be
+      performed elsewhere (e.g., in a background thread by
+      \ref SysSnapshot). The function must only be called once.
+    */
+    std::function<std::string()> getDeferredConfigXML(bool applyBC = true, bool round = false);
+
+    /*! \brief Renders the results of the Simulation to a string.
+
+      This is the XML written by \ref outputData.
+    */
+    std::string getOutputDataXML();
+
     /*! \brief The Ensemble of the Simulation. */
     shared_ptr<Ensemble> ensemble;
 
@@ -324,6 +363,14 @@ namespace dynamo
     //! Scales the frequency of the SysTicker event by the passed factor.
     void scaleTickerPeriod(double);
 
+    //! Run the snapshot ticker plugins in the background (see SysTicker::setAsync).
+    void setTickerAsync(bool);
+
+    /*! \brief Wait for any ticker plugins still running in the
+        background, so that their data may be read.
+     */
+    void waitForTickers();
+
 
     /*! \brief The current system time of the simulation. 
       
@@ -349,7 +396,14 @@ namespace dynamo
     size_t N() const { return particles.size(); }
     
     /*! \brief The Particle's of the system. */
-    std::vector<Particle> particles;  
+    ParticleList particles;
+
+    /*! \brief How many events between reordering the particle
+        storage along a space filling curve (zero disables this).
+
+      See sortParticles().
+     */
+    size_t particleSortInterval;
     
     /*! \brief A ptr to the Scheduler of the system. */
     shared_ptr<Scheduler> ptrScheduler;
@@ -362,6 +416,17 @@ namespace dynamo
 
     /*! \brief The random number generator of the system. */
     mutable baseRNG ranGenerator;
+
+    /*! \brief A ThreadPool which may be used to parallelise work
+        within this Simulation (currently only the full rebuilds of
+        the event list, see Scheduler::rebuildList()).
+
+      This is set by the Engine running the Simulation and is NULL if
+      the Simulation must run serially (e.g., when the Simulation
+      itself is being run as a task of the ThreadPool, as in the
+      EReplicaExchangeSimulation engine).
+     */
+    magnet::thread::ThreadPool* threadPool;
     
     /*! \brief The collection of OutputPlugin's operating on this system.
      */
@@ -407,6 +472,61 @@ namespace dynamo
 
   private:
     size_t _nextPrint;
+    size_t _nextParticleSort;
+
+    /*! \brief Writes the XML representation of the configuration.
+
+      \param particleData If false, the ParticleData tag is left
+      empty as the particle data is stored elsewhere (e.g., in a
+      binary configuration file).
+     */
+    void outputConfigXML(magnet::xml::XmlStream& XML, bool applyBC, bool particleData) const;
+
+    /*! \brief Writes the start of the configuration, up to the
+        ParticleData tag.
+     */
+    void outputConfigHeadXML(magnet::xml::XmlStream& XML) const;
+
+    /*! \brief Writes the configuration in the configuration file
+        units, including the particle data.
+     */
+    void writeConfigXML(magnet::xml::XmlStream& XML, bool applyBC, bool round);
+
+    void outputDataXML(magnet::xml::XmlStream& XML);
+
+    void writeBinaryFile(std::string filename, bool applyBC);
+
+    void loadParticleBinaryData(const binary::Reader& file);
+
+    /*! \brief The candidate Interactions for a pairing of two
+        species.
+
+	The Interaction IDs are stored in the order they must be
+	tested. If \ref covered is true, the last candidate is known
+	to contain every pairing of the two species and is returned
+	without being tested.
+     */
+    struct InteractionCandidates
+    {
+      std::vector<size_t> IDs;
+      bool covered;
+    };
+
+    /*! \brief A species-pair dispatch table for getInteraction().
+
+	The entry for a pair of species with indices \f$i\f$ and
+	\f$j\f$ is at \f$i\,N_{species}+j\f$. It is empty until
+	the Species have been initialised, in which case the
+	Interactions are searched linearly.
+     */
+    std::vector<InteractionCandidates> _interactionTable;
+
+    /*! \brief The index of the Species of each particle, used to
+        look up the \ref _interactionTable.
+     */
+    std::vector<size_t> _particleSpecies;
+
+    void buildInteractionTable();
   };
 
 }
@@ -49,7 +49,7 @@ namespace dynamo {
 
     initialSupportedRange = nblist.getMaxInteractionRange();
       
-    dt = (nblist.getMaxSupportedInteractionLength() / initialSupportedRange - 1.0) 
+    dt = (nblist.getRebuildRange() / initialSupportedRange - 1.0) 
       / growthRate - Sim->systemTime;
 
     dout << "Compression Hack Loaded"
@@ -60,7 +60,7 @@ namespace dynamo {
 	 << "\nMax length of interaction = " 
 	 << nblist.getMaxSupportedInteractionLength() / Sim->units.unitLength()
 	 << "\nMaximum supported length = "
-	 << nblist.getMaxSupportedInteractionLength() / Sim->units.unitLength()
+	 << nblist.getRebuildRange() / Sim->units.unitLength()
 	 << "\nFirst halt scheduled for " 
 	 << dt / Sim->units.unitTime() << std::endl;
   }
@@ -89,9 +89,9 @@ namespace dynamo {
 	 << "\nNColl = " << Sim->eventCount
 	 << "\nSys t = " << Sim->systemTime / Sim->units.unitTime() << std::endl;
   
-    nblist.setMaxInteractionRange(nblist.getMaxSupportedInteractionLength() * 1.1);
+    nblist.setMaxInteractionRange(nblist.getRebuildRange() * 1.1);
   
-    dt = (nblist.getMaxSupportedInteractionLength()
+    dt = (nblist.getRebuildRange()
 	  / initialSupportedRange - 1.0) / growthRate - Sim->systemTime;
 
     NEventData SDat;
@@ -23,13 +23,27 @@
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <magnet/string/searchreplace.hpp>
+#include <magnet/compression/bzip2.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 namespace dynamo {
+  namespace {
+    void writeCompressedFile(const std::string& fileName, const std::string& data)
+    {
+      magnet::thread::ThreadPool serialPool;
+      boost::iostreams::filtering_ostream file;
+      file.push(magnet::compression::bzip2_parallel_sink(fileName, serialPool));
+      file.write(data.data(), data.size());
+    }
+  }
+
   SysSnapshot::SysSnapshot(dynamo::Simulation* nSim, double nPeriod, std::string nName, std::string format, bool applyBC):
     System(nSim),
     _applyBC(applyBC),
     _format(format),
-    _saveCounter(0)
+    _saveCounter(0),
+    _async(false)
   {
     if (nPeriod <= 0.0)
       nPeriod = 1.0;
@@ -48,7 +62,8 @@ namespace dynamo {
     System(nSim),
     _applyBC(applyBC),
     _format(format),
-    _saveCounter(0)
+    _saveCounter(0),
+    _async(false)
   {
     _period = 0;
     dt = HUGE_VAL;
@@ -101,13 +116,46 @@ namespace dynamo {
   
     std::string filename = magnet::string::search_replace("Snapshot."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter));
     filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
+    std::string outputFilename = magnet::string::search_replace("Snapshot.output."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter++));
+    outputFilename = magnet::string::search_replace(outputFilename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
+
+    if (_async)
+      {
+	//Only one snapshot is held in memory at a time
+	waitForWrite();
+	dout << "Printing SNAPSHOT (in the background)" << std::endl;
+
+	//The particle data is only copied here, and is formatted in
+	//the background. The output data of the plugins is small, so
+	//it is rendered now, which is also the only way to copy it.
+	const std::function<std::string()> config = Sim->getDeferredConfigXML(_applyBC);
+	std::shared_ptr<std::string> output(new std::string(Sim->getOutputDataXML()));
+	_pendingWrite = std::async(std::launch::async, [=]() {
+	    writeCompressedFile(filename, config());
+	    writeCompressedFile(outputFilename, *output);
+	  });
+	return;
+      }
+
     Sim->writeXMLfile(filename, _applyBC);
     
     dout << "Printing SNAPSHOT" << std::endl;
     
-    filename = magnet::string::search_replace("Snapshot.output."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter++));
-    filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
-    Sim->outputData(filename);
+    Sim->outputData(outputFilename);
+  }
+
+  SysSnapshot::~SysSnapshot()
+  {
+    try { waitForWrite(); }
+    catch (std::exception& err)
+      { derr << "Failed to write a snapshot:\n" << err.what() << std::endl; }
+  }
+
+  void
+  SysSnapshot::waitForWrite()
+  {
+    if (_pendingWrite.valid())
+      _pendingWrite.get();
   }
 
   void 
@@ -17,14 +17,27 @@
 
 #pragma once
 #include <dynamo/systems/system.hpp>
+#include <future>
 
 namespace dynamo {
-  //! \brief A System Event which periodically saves the state of the system.
+  /*! \brief A System Event which periodically saves the state of the system.
+
+    In asynchronous mode (see \ref setAsync), the particle data is
+    copied at the snapshot instant, and its (slow) XML formatting,
+    the compression and the file output are carried out in a
+    background thread while the simulation continues. The rest of
+    the configuration and the output data are small and are rendered
+    at the snapshot instant. Only one snapshot may be pending at a
+    time, so the memory use is bounded to a single copy of the
+    output.
+   */
   class SysSnapshot: public System
   {
   public:
     SysSnapshot(dynamo::Simulation*, double, std::string, std::string, bool);
     SysSnapshot(dynamo::Simulation*, size_t, std::string, std::string, bool);
+
+    ~SysSnapshot();
   
     virtual void runEvent();
 
@@ -49,7 +62,14 @@ namespace dynamo {
 
     void setTickerPeriod(const double&);
 
+    void setAsync(bool async) { _async = async; }
+
   protected:
+    /*! \brief Wait for the pending background write (if any) to
+        complete, rethrowing any error it encountered.
+     */
+    void waitForWrite();
+
     void eventCallback(const NEventData&);
     virtual void outputXML(magnet::xml::XmlStream&) const {}
 
@@ -59,5 +79,7 @@ namespace dynamo {
     size_t _saveCounter;
     size_t _eventPeriod;
     size_t _lastEventCount;
+    bool _async;
+    std::future<void> _pendingWrite;
   };
 }
@@ -25,7 +25,8 @@
 
 namespace dynamo {
   SysTicker::SysTicker(dynamo::Simulation* nSim, double nPeriod, std::string nName):
-    System(nSim)
+    System(nSim),
+    _async(false)
   {
     if (nPeriod <= 0.0)
       nPeriod = Sim->units.unitTime();
@@ -62,16 +63,47 @@ namespace dynamo {
     //This is done here as most ticker properties require it
     Sim->dynamics->updateAllParticles();
 
+    //The snapshot cannot be overwritten while the plugins of the
+    //last tick are still reading it
+    waitForTickers();
+
+    std::vector<shared_ptr<OPSnapshotTicker> > asyncTickers;
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       {
 	shared_ptr<OPTicker> ptr = std::dynamic_pointer_cast<OPTicker>(Ptr);
-	if (ptr) ptr->ticker();
+	if (!ptr) continue;
+
+	shared_ptr<OPSnapshotTicker> snapshotPtr = std::dynamic_pointer_cast<OPSnapshotTicker>(ptr);
+	if (_async && snapshotPtr)
+	  asyncTickers.push_back(snapshotPtr);
+	else
+	  ptr->ticker();
+      }
+
+    //The asynchronous tickers get their own thread rather than a
+    //slot on Sim->threadPool, as any fork-join work in the event
+    //loop waits for the whole pool. The future carries any exception
+    //back to waitForTickers().
+    if (!asyncTickers.empty())
+      {
+	_snapshot = Sim->particles;
+	_pendingTicker = std::async(std::launch::async, [this, asyncTickers]() {
+	    for (const shared_ptr<OPSnapshotTicker>& ptr : asyncTickers)
+	      ptr->snapshotTicker(_snapshot);
+	  });
       }
 
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       Ptr->eventUpdate(*this, NEventData(), locdt);
   }
 
+  void
+  SysTicker::waitForTickers()
+  {
+    if (_pendingTicker.valid())
+      _pendingTicker.get();
+  }
+
   void 
   SysTicker::initialise(size_t nID)
   { ID = nID; }
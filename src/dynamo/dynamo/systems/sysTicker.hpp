@@ -17,8 +17,19 @@
 
 #pragma once
 #include <dynamo/systems/system.hpp>
+#include <dynamo/particle.hpp>
+#include <future>
 
 namespace dynamo {
+  /*! \brief A System Event which periodically "ticks" the OPTicker
+      output plugins.
+
+    In asynchronous mode (see \ref setAsync), the OPSnapshotTicker
+    plugins are run in a separate thread and the event loop continues
+    immediately, with a copy of the particles for them to read. Only
+    one tick may be pending at a time, so the copy is not taken again
+    until they have finished.
+   */
   class SysTicker: public System
   {
   public:
@@ -38,6 +49,13 @@ namespace dynamo {
 
     const double& getPeriod() const { return period; }
 
+    void setAsync(bool async) { _async = async; }
+
+    /*! \brief Wait for the plugins of the last tick to finish,
+        rethrowing any exception they raised.
+     */
+    void waitForTickers();
+
     virtual void replicaExchange(System& os) { 
       SysTicker& s = static_cast<SysTicker&>(os);
       std::swap(dt, s.dt);
@@ -48,5 +66,8 @@ namespace dynamo {
     virtual void outputXML(magnet::xml::XmlStream&) const {}
 
     double period;
+    bool _async;
+    std::future<void> _pendingTicker;
+    ParticleList _snapshot;
   };
 }
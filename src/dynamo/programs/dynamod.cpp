@@ -47,7 +47,7 @@ main(int argc, char *argv[])
 
       allopts.add_options()
 	("help,h", "Produces this message OR if --pack-mode/-m is set, it lists the specific options available for that packer mode.")
-	("out-config-file,o", po::value<string>()->default_value("config.out.xml.bz2"), "Configuration output file.")
+	("out-config-file,o", po::value<string>()->default_value("config.out.xml.bz2"), "Configuration output file. The format is selected by the extension: \".xml\", \".xml.bz2\" or \".bin\" (binary).")
 	("random-seed,s", po::value<unsigned int>(), "Seed value for the random number generator.")
 	("rescale-T,r", po::value<double>(), "Rescales the kinetic temperature of the input/generated config to this value.")
 	("thermostat,T", po::value<double>(), "Change or add a thermostatt with the temperature provided. A temperature of zero will remove the thermostatt.")
@@ -62,7 +62,7 @@ main(int argc, char *argv[])
 	;
 
       loadopts.add_options()
-	("config-file", po::value<string>(), "Config file to initialise from (Non packer mode).")
+	("config-file", po::value<string>(), "Config file to initialise from (Non packer mode). This may be a \".xml\", \".xml.bz2\" or \".bin\" (binary) file.")
 	;
       
       
@@ -0,0 +1,147 @@
+#define BOOST_TEST_MODULE BinaryConfig_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/squarewell.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <random>
+
+std::mt19937 RNG;
+typedef dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > DefaultSorter;
+
+dynamo::Vector getRandVelVec()
+{
+  //See http://mathworld.wolfram.com/SpherePointPicking.html
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+void init(dynamo::Simulation& Sim)
+{
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new DefaultSorter()));
+
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(std::array<long, 3>{{5,5,5}}, dynamo::Vector(1,1,1), new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(packptr->placeObjects(dynamo::Vector(0,0,0)));
+  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+
+  const size_t N = latticeSites.size();
+  const double particleDiam = std::cbrt(0.5 / N);
+
+  //A polydisperse mass is used to check the Property data is stored
+  dynamo::shared_ptr<dynamo::ParticleProperty> M(new dynamo::ParticleProperty(N, dynamo::Property::Units::Mass(), "M", 1.0));
+  Sim._properties.push(M);
+  for (size_t i(0); i < N; ++i)
+    M->getProperty(i) = 1.0 + 0.5 * (i % 3);
+
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::ISquareWell(&Sim, particleDiam, 1.5, 1.0, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), "M", "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+  Sim.units.setUnitTime(particleDiam);
+
+  Sim.particles.reserve(N);
+  for (const dynamo::Vector & position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(position, getRandVelVec() * Sim.units.unitVelocity(), Sim.particles.size()));
+  Sim.particles[3].clearState(dynamo::Particle::DYNAMIC);
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+BOOST_AUTO_TEST_CASE( Binary_Round_Trip )
+{
+  //Run the system for a while so that the capture map is filled
+  dynamo::Simulation Sim;
+  init(Sim);
+  Sim.endEventCount = 10000;
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  //Store the particles out of ID order, to check the files are
+  //written and read by ID
+  std::vector<size_t> order(Sim.N());
+  for (size_t i(0); i < Sim.N(); ++i)
+    order[i] = Sim.N() - 1 - i;
+  Sim.particles.reorder(order);
+
+  Sim.writeXMLfile("binaryconfig.xml", false);
+  Sim.writeXMLfile("binaryconfig.bin", false);
+
+  dynamo::Simulation XMLSim, BinSim;
+  XMLSim.loadXMLfile("binaryconfig.xml");
+  BinSim.loadXMLfile("binaryconfig.bin");
+
+  //The binary file is lossless, so the loaded state must exactly
+  //match the original state (in its configuration file units)
+  BOOST_REQUIRE_EQUAL(BinSim.N(), Sim.N());
+  for (size_t i(0); i < Sim.N(); ++i)
+    {
+      BOOST_CHECK_EQUAL(BinSim.particles[i].getID(), i);
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  BOOST_CHECK_EQUAL(BinSim.particles[i].getPosition()[iDim], Sim.particles[i].getPosition()[iDim] / Sim.units.unitLength());
+	  BOOST_CHECK_EQUAL(BinSim.particles[i].getVelocity()[iDim], Sim.particles[i].getVelocity()[iDim] / Sim.units.unitVelocity());
+	}
+      BOOST_CHECK_EQUAL(BinSim.particles[i].testState(dynamo::Particle::DYNAMIC), Sim.particles[i].testState(dynamo::Particle::DYNAMIC));
+      BOOST_CHECK_EQUAL(BinSim.species[0]->getMass(i), Sim.species[0]->getMass(i) / Sim.units.unitMass());
+    }
+
+  const dynamo::ISquareWell& simInt = static_cast<const dynamo::ISquareWell&>(*Sim.interactions[0]);
+  const dynamo::ISquareWell& binInt = static_cast<const dynamo::ISquareWell&>(*BinSim.interactions[0]);
+  BOOST_CHECK(simInt.size() > 0);
+  BOOST_CHECK_EQUAL(binInt.size(), simInt.size());
+  for (const auto& entry : simInt)
+    BOOST_CHECK_EQUAL(binInt.isCaptured(entry.first.first, entry.first.second), entry.second);
+
+  //The XML file is rounded to its printed precision
+  BOOST_REQUIRE_EQUAL(XMLSim.N(), Sim.N());
+  for (size_t i(0); i < Sim.N(); ++i)
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	BOOST_CHECK_CLOSE(BinSim.particles[i].getPosition()[iDim], XMLSim.particles[i].getPosition()[iDim], 1e-12);
+	BOOST_CHECK_CLOSE(BinSim.particles[i].getVelocity()[iDim], XMLSim.particles[i].getVelocity()[iDim], 1e-12);
+      }
+
+  const dynamo::ISquareWell& xmlInt = static_cast<const dynamo::ISquareWell&>(*XMLSim.interactions[0]);
+  BOOST_CHECK_EQUAL(xmlInt.size(), simInt.size());
+  for (const auto& entry : simInt)
+    BOOST_CHECK_EQUAL(xmlInt.isCaptured(entry.first.first, entry.first.second), entry.second);
+
+  //Writing the binary file must not remove the capture map from the
+  //XML output
+  Sim.writeXMLfile("binaryconfig2.xml", false);
+  dynamo::Simulation XMLSim2;
+  XMLSim2.loadXMLfile("binaryconfig2.xml");
+  BOOST_CHECK_EQUAL(static_cast<const dynamo::ISquareWell&>(*XMLSim2.interactions[0]).size(), simInt.size());
+
+  //Finally, check the loaded configuration runs. Particles which
+  //have just had an event may be flagged as invalid due to rounding.
+  BinSim.endEventCount = 10000;
+  BinSim.addOutputPlugin("Misc");
+  BinSim.initialise();
+  BOOST_CHECK_MESSAGE(BinSim.checkSystem() <= 2, "There are more than two invalid states in the binary configuration");
+  const double totalEinit = BinSim.getOutputPlugin<dynamo::OPMisc>()->getTotalEnergy();
+  while (BinSim.runSimulationStep()) {}
+  const double totalEequil = BinSim.getOutputPlugin<dynamo::OPMisc>()->getTotalEnergy();
+  BOOST_CHECK_CLOSE(totalEinit, totalEequil, 0.000000001);
+}
@@ -15,6 +15,7 @@
 #include <dynamo/interactions/hardsphere.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/locals/lwall.hpp>
+#include <dynamo/globals/cells.hpp>
 #include <random>
 
 std::mt19937 RNG;
@@ -32,7 +33,11 @@ dynamo::Vector getRandVelVec()
   return tmpVec;
 }
 
-void init(dynamo::Simulation& Sim, const double density)
+/* If sparse is true, the box is 20 times taller than the packing
+   and uses sparse cells. The plate and the particles resting on it
+   are placed at the bottom of the box.
+ */
+void init(dynamo::Simulation& Sim, const double density, const bool sparse = false)
 {
   RNG.seed(std::random_device()());
   Sim.ranGenerator.seed(std::random_device()());
@@ -43,7 +48,7 @@ void init(dynamo::Simulation& Sim, const double density)
   packptr->initialise();
   std::vector<dynamo::Vector> latticeSites(packptr->placeObjects(dynamo::Vector(0,0,0)));
 
-  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+  Sim.primaryCellSize = dynamo::Vector(1, sparse ? 20 : 1, 1);
 
   double particleDiam = std::cbrt(density / latticeSites.size());
 
@@ -55,12 +60,22 @@ void init(dynamo::Simulation& Sim, const double density)
   Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
   Sim.units.setUnitLength(particleDiam);
 
-  Sim.locals.push_back(dynamo::shared_ptr<dynamo::Local>(new dynamo::LWall(&Sim, 1.0, particleDiam, dynamo::Vector(0, 1, 0), dynamo::Vector(0, - 0.5 * Sim.primaryCellSize[1] - 0.5 * particleDiam, 0), "GroundPlate", new dynamo::IDRangeAll(&Sim))));
+  //The packing is one unit tall, centred on the origin
+  const dynamo::Vector bottom(0, 0.5 - 0.5 * Sim.primaryCellSize[1], 0);
+
+  Sim.locals.push_back(dynamo::shared_ptr<dynamo::Local>(new dynamo::LWall(&Sim, 1.0, particleDiam, dynamo::Vector(0, 1, 0), bottom + dynamo::Vector(0, - 0.5 - 0.5 * particleDiam, 0), "GroundPlate", new dynamo::IDRangeAll(&Sim))));
   
+  if (sparse)
+    {
+      dynamo::GCells* nblist = new dynamo::GCells(&Sim, "SchedulerNBList");
+      nblist->setSparse(true);
+      Sim.globals.push_back(dynamo::shared_ptr<dynamo::Global>(nblist));
+    }
+
   unsigned long nParticles = 0;
   Sim.particles.reserve(latticeSites.size());
   for (const dynamo::Vector & position : latticeSites)
-    Sim.particles.push_back(dynamo::Particle(0.999 * position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+    Sim.particles.push_back(dynamo::Particle(bottom + 0.999 * position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
 
   Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
 
@@ -68,7 +83,7 @@ void init(dynamo::Simulation& Sim, const double density)
   dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
 
   BOOST_CHECK_EQUAL(Sim.N(), 1372);
-  BOOST_CHECK_CLOSE(Sim.getNumberDensity() * Sim.units.unitVolume(), density, 0.000000001);
+  BOOST_CHECK_CLOSE(Sim.getNumberDensity() * Sim.units.unitVolume() * Sim.primaryCellSize[1], density, 0.000000001);
   BOOST_CHECK_CLOSE(Sim.getPackingFraction(), Sim.getNumberDensity() * Sim.units.unitVolume() * M_PI / 6.0, 0.000000001);
 }
 
@@ -99,3 +114,28 @@ BOOST_AUTO_TEST_CASE( Simulation )
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
 }
 
+
+BOOST_AUTO_TEST_CASE( Sparse_Cells_Simulation )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.1, true);
+    Sim.writeXMLfile("HSgravityplatesparse.xml");
+  }
+
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("HSgravityplatesparse.xml");
+
+  Sim.endEventCount = 100000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  //The extra empty space above the particles should not change the
+  //dynamics
+  const double expectedMFT = 3.55501052762802;
+  double MFT = Sim.getOutputPlugin<dynamo::OPMisc>()->getMFT();
+  BOOST_CHECK_CLOSE(MFT, expectedMFT, 6);
+
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
+}
@@ -15,6 +15,13 @@
 #include <dynamo/interactions/hardsphere.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/outputplugins/msd.hpp>
+#include <dynamo/outputplugins/tickerproperty/radialdist.hpp>
+#include <dynamo/outputplugins/tickerproperty/msdmultitau.hpp>
+#include <dynamo/outputplugins/tickerproperty/SHcrystal.hpp>
+#include <dynamo/systems/sysTicker.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <fstream>
 #include <random>
 
 std::mt19937 RNG;
@@ -123,6 +130,27 @@ BOOST_AUTO_TEST_CASE( Equilibrium_Simulation )
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
 }
 
+BOOST_AUTO_TEST_CASE( Deferred_Config )
+{
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+  Sim.endEventCount = 20000;
+  Sim.initialise();
+  for (size_t i(0); i < 10000; ++i)
+    Sim.runSimulationStep();
+
+  //The deferred configuration must be the one at the instant it was
+  //taken, even if it is only rendered after the simulation has moved on
+  const std::function<std::string()> deferred = Sim.getDeferredConfigXML();
+  Sim.writeXMLfile("HSdeferred.xml");
+  while (Sim.runSimulationStep()) {}
+
+  std::ifstream file("HSdeferred.xml");
+  const std::string config((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  BOOST_CHECK(!config.empty());
+  BOOST_CHECK(deferred() == config);
+}
+
 BOOST_AUTO_TEST_CASE( Compression_Simulation )
 {
   dynamo::Simulation Sim;
@@ -150,3 +178,197 @@ BOOST_AUTO_TEST_CASE( Compression_Simulation )
 
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "After compression, there are more than one invalid states in the final configuration");
 }
+
+BOOST_AUTO_TEST_CASE( Sorted_Particle_Storage )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("HSsort.xml");
+  }
+
+  //Reordering the particles and cells in memory must not change the
+  //dynamics
+  dynamo::Simulation Sim1, Sim2;
+  Sim1.loadXMLfile("HSsort.xml");
+  Sim2.loadXMLfile("HSsort.xml");
+  Sim2.particleSortInterval = 10000;
+  dynamo::GCells* nblist = new dynamo::GCells(&Sim2, "SchedulerNBList");
+  nblist->setMortonOrdering(true);
+  Sim2.globals.push_back(dynamo::shared_ptr<dynamo::Global>(nblist));
+
+  for (dynamo::Simulation* Sim : {&Sim1, &Sim2})
+    {
+      Sim->endEventCount = 100000;
+      Sim->initialise();
+      while (Sim->runSimulationStep(true)) {}
+      Sim->dynamics->updateAllParticles();
+    }
+
+  for (size_t ID(0); ID < Sim1.N(); ++ID)
+    {
+      BOOST_CHECK_EQUAL(Sim2.particles[ID].getID(), ID);
+      BOOST_CHECK_SMALL((Sim1.particles[ID].getPosition() - Sim2.particles[ID].getPosition()).nrm(), 1e-10);
+    }
+
+  BOOST_CHECK_MESSAGE(Sim2.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
+}
+
+BOOST_AUTO_TEST_CASE( Radial_Distribution )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("HSgr.xml");
+  }
+
+  //The first simulation only samples up to two diameters, which is
+  //within the range of its cells, so it only visits the neighbours
+  //of each particle. The second samples all pairs up to half the box.
+  dynamo::Simulation Sim1, Sim2;
+  Sim1.loadXMLfile("HSgr.xml");
+  Sim2.loadXMLfile("HSgr.xml");
+  dynamo::GCells* nblist = new dynamo::GCells(&Sim1, "SchedulerNBList");
+  nblist->setMaxInteractionRange(2 * Sim1.units.unitLength());
+  Sim1.globals.push_back(dynamo::shared_ptr<dynamo::Global>(nblist));
+  Sim1.addOutputPlugin("RadialDistribution:BinWidth=0.05,Length=40");
+  Sim2.addOutputPlugin("RadialDistribution:BinWidth=0.05");
+
+  for (dynamo::Simulation* Sim : {&Sim1, &Sim2})
+    {
+      Sim->endEventCount = 20000;
+      Sim->addOutputPlugin("Misc");
+      Sim->initialise();
+      while (Sim->runSimulationStep(true)) {}
+    }
+
+  const dynamo::OPRadialDistribution& local = *Sim1.getOutputPlugin<dynamo::OPRadialDistribution>();
+  BOOST_CHECK(39.5 * local.getBinWidth() <= Sim1.ptrScheduler->getNeighbourhoodDistance());
+
+  //Sampling only the neighbours must give exactly the same g(r) as
+  //sampling all pairs
+  const std::vector<std::pair<double, double> > localgr = local.getgrdata(0, 0);
+  const std::vector<std::pair<double, double> > allpairsgr = Sim2.getOutputPlugin<dynamo::OPRadialDistribution>()->getgrdata(0, 0);
+  BOOST_CHECK_EQUAL(localgr.size(), 40);
+  BOOST_CHECK(allpairsgr.size() > localgr.size());
+  for (size_t i(0); i < localgr.size(); ++i)
+    BOOST_CHECK_EQUAL(localgr[i].second, allpairsgr[i].second);
+
+  //There are no overlaps, but there is a contact peak
+  BOOST_CHECK_EQUAL(localgr[10].second, 0);
+  BOOST_CHECK(localgr[21].second > 1);
+}
+
+BOOST_AUTO_TEST_CASE( MultiTau_MSD )
+{
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+
+  Sim.endEventCount = 200000;
+  Sim.addOutputPlugin("Misc");
+  Sim.addOutputPlugin("MSDMultiTau:VACF");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  const dynamo::OPMSDMultiTau& multitau = *Sim.getOutputPlugin<dynamo::OPMSDMultiTau>();
+  const double dt = dynamic_cast<const dynamo::SysTicker&>(*Sim.systems["SystemTicker"]).getPeriod() / Sim.units.unitTime();
+
+  //The lags should span the whole run, with a MSD which grows
+  //with the lag
+  const std::vector<dynamo::OPMSDMultiTau::MSDCorrelator::Data> msd = multitau.getMSDCorrelator().getAveragedCorrelator(0);
+  BOOST_REQUIRE(msd.size() > 16);
+  BOOST_CHECK_EQUAL(msd.front().value, 0);
+  BOOST_CHECK(4 * msd.back().lag >= multitau.getMSDCorrelator().getPushCount());
+  for (size_t i(1); i < msd.size(); ++i)
+    BOOST_CHECK(msd[i].value > msd[i-1].value);
+
+  //At long times the MSD gives the diffusion coefficient (Lue 2005
+  //DOI:10.1063/1.1834498), checked where there are plenty of time
+  //origins
+  for (const dynamo::OPMSDMultiTau::MSDCorrelator::Data& data : msd)
+    if ((data.lag * dt > 5) && (data.sample_count > 20))
+      BOOST_CHECK_CLOSE(data.value / (Sim.units.unitArea() * 6 * data.lag * dt), 0.247, 15);
+
+  //The VACF at zero lag is 3 kT / m, which is conserved exactly
+  const std::vector<dynamo::OPMSDMultiTau::VACFCorrelator::Data> vacf = multitau.getVACFCorrelator().getAveragedCorrelator(0);
+  BOOST_REQUIRE(!vacf.empty());
+  BOOST_CHECK_CLOSE(vacf.front().value / (Sim.units.unitVelocity() * Sim.units.unitVelocity()), 3.0, 0.000001);
+}
+
+BOOST_AUTO_TEST_CASE( Async_Ticker )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("HSticker.xml");
+  }
+
+  //The pool must outlive the simulations using it
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(2);
+
+  //The second simulation runs its snapshot plugins in the
+  //background, alongside a thread pool for its fork-join work, which
+  //must not change the data they collect
+  dynamo::Simulation Sim1, Sim2;
+  Sim1.loadXMLfile("HSticker.xml");
+  Sim2.loadXMLfile("HSticker.xml");
+  Sim2.threadPool = &pool;
+
+  for (dynamo::Simulation* Sim : {&Sim1, &Sim2})
+    {
+      Sim->endEventCount = 50000;
+      Sim->addOutputPlugin("Misc");
+      Sim->addOutputPlugin("MSDMultiTau:VACF");
+      Sim->addOutputPlugin("KEnergyTicker");
+      Sim->addOutputPlugin("RadialDistribution");
+      Sim->initialise();
+      Sim->setTickerPeriod(0.05);
+    }
+  Sim2.setTickerAsync(true);
+
+  for (dynamo::Simulation* Sim : {&Sim1, &Sim2})
+    while (Sim->runSimulationStep(true)) {}
+
+  Sim2.waitForTickers();
+
+  const std::vector<dynamo::OPMSDMultiTau::MSDCorrelator::Data> msd1 = Sim1.getOutputPlugin<dynamo::OPMSDMultiTau>()->getMSDCorrelator().getAveragedCorrelator(0);
+  const std::vector<dynamo::OPMSDMultiTau::MSDCorrelator::Data> msd2 = Sim2.getOutputPlugin<dynamo::OPMSDMultiTau>()->getMSDCorrelator().getAveragedCorrelator(0);
+  BOOST_CHECK(msd1.size() > 16);
+  BOOST_REQUIRE_EQUAL(msd1.size(), msd2.size());
+  for (size_t i(0); i < msd1.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(msd1[i].lag, msd2[i].lag);
+      BOOST_CHECK_EQUAL(msd1[i].sample_count, msd2[i].sample_count);
+      BOOST_CHECK_EQUAL(msd1[i].value, msd2[i].value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( Bond_Order_FCC )
+{
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(2);
+
+  //The initial configuration is a perfect FCC crystal with a nearest
+  //neighbour distance of sqrt(2) diameters at this density
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+  Sim.threadPool = &pool;
+  dynamo::GCells* nblist = new dynamo::GCells(&Sim, "SchedulerNBList");
+  nblist->setMaxInteractionRange(1.7 * Sim.units.unitLength());
+  Sim.globals.push_back(dynamo::shared_ptr<dynamo::Global>(nblist));
+  Sim.endEventCount = 1;
+  Sim.addOutputPlugin("SHCrystal:CutOffR=1.6");
+  Sim.initialise();
+
+  //Every particle sees the ideal FCC bond order (Steinhardt et al.
+  //1983 DOI:10.1103/PhysRevB.28.784)
+  const dynamo::OPSHCrystal& shcrystal = *Sim.getOutputPlugin<dynamo::OPSHCrystal>();
+  BOOST_REQUIRE_EQUAL(shcrystal.getLocalQ6().size(), Sim.N());
+  for (size_t i(0); i < Sim.N(); ++i)
+    {
+      BOOST_CHECK_CLOSE(shcrystal.getLocalQ4()[i], 0.190941, 0.001);
+      BOOST_CHECK_CLOSE(shcrystal.getLocalQ6()[i], 0.574524, 0.001);
+      BOOST_CHECK_CLOSE(shcrystal.getLocalW6()[i], -0.0131606, 0.01);
+    }
+}
@@ -0,0 +1,215 @@
+#define BOOST_TEST_MODULE MultiCells_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/ranges/IDRangeRange.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/globals/multicells.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <algorithm>
+#include <random>
+
+std::mt19937 RNG;
+typedef dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > DefaultSorter;
+
+dynamo::Vector getRandVelVec()
+{
+  //See http://mathworld.wolfram.com/SpherePointPicking.html
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+/* A binary hard sphere mixture of Na large particles, with the
+   remaining particles of the FCC lattice being small. The
+   NeighbourhoodRange of each level is its particle diameter times
+   rangeScale.
+ */
+void init(dynamo::Simulation& Sim, const std::vector<dynamo::Vector>& positions, size_t Na, double diamA, double diamB,
+	  double rangeScale = 1.0)
+{
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new DefaultSorter()));
+  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+
+  const size_t N = positions.size();
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, diamA, new dynamo::IDPairRangeSingle(new dynamo::IDRangeRange(0, Na - 1)), "AAInt")));
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, 0.5 * (diamA + diamB), new dynamo::IDPairRangePair(new dynamo::IDRangeRange(0, Na - 1), new dynamo::IDRangeRange(Na, N - 1)), "ABInt")));
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, diamB, new dynamo::IDPairRangeAll(), "BBInt")));
+
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeRange(0, Na - 1), 1.0, "A", 0)));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeRange(Na, N - 1), 0.001, "B", 0)));
+
+  dynamo::GMultiCells* nblist = new dynamo::GMultiCells(&Sim, "SchedulerNBList");
+  nblist->addLevel(new dynamo::IDRangeRange(0, Na - 1), diamA * rangeScale);
+  nblist->addLevel(new dynamo::IDRangeRange(Na, N - 1), diamB * rangeScale);
+  Sim.globals.push_back(dynamo::shared_ptr<dynamo::Global>(nblist));
+
+  Sim.units.setUnitLength(diamA);
+
+  unsigned long nParticles = 0;
+  Sim.particles.reserve(N);
+  for (const dynamo::Vector & position : positions)
+    Sim.particles.push_back(dynamo::Particle(position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+std::vector<dynamo::Vector> getFCCSites()
+{
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(std::array<long, 3>{{10, 10, 10}}, dynamo::Vector(1, 1, 1), new dynamo::UParticle()));
+  packptr->initialise();
+  return packptr->placeObjects(dynamo::Vector(0,0,0));
+}
+
+/* Check that every pair of particles within interaction range are
+   neighbours of each other.
+ */
+void checkNeighbours(dynamo::Simulation& Sim)
+{
+  Sim.dynamics->updateAllParticles();
+  size_t missing = 0;
+  for (const dynamo::Particle& p1 : Sim.particles)
+    {
+      std::unique_ptr<dynamo::IDRange> ids(Sim.ptrScheduler->getParticleNeighbours(p1));
+      std::vector<size_t> neighbours(ids->begin(), ids->end());
+      std::sort(neighbours.begin(), neighbours.end());
+
+      for (const dynamo::Particle& p2 : Sim.particles)
+	{
+	  if (p1 == p2) continue;
+	  dynamo::Vector rij = p1.getPosition() - p2.getPosition();
+	  Sim.BCs->applyBC(rij);
+	  if ((rij.nrm() <= Sim.getInteraction(p1, p2)->maxIntDist())
+	      && !std::binary_search(neighbours.begin(), neighbours.end(), p2.getID()))
+	    ++missing;
+	}
+    }
+
+  BOOST_CHECK_EQUAL(missing, 0);
+}
+
+BOOST_AUTO_TEST_CASE( Equilibrium_Simulation )
+{
+  //The same system as the binaryhardsphere_test, but with a level
+  //for each species
+  std::vector<dynamo::Vector> sites = getFCCSites();
+  const double particleDiam = std::cbrt(1.4 / sites.size());
+
+  {
+    dynamo::Simulation Sim;
+    init(Sim, sites, 100, particleDiam, 0.5 * particleDiam);
+    Sim.writeXMLfile("MultiCellsequil.xml");
+  }
+
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("MultiCellsequil.xml");
+
+  Sim.endEventCount = 1000000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  Sim.reset();
+  Sim.endEventCount = 1000000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  //Taken from Lue 2005 DOI:10.1063/1.1834498
+  const double expectedMFT = 0.0098213311089127;
+
+  dynamo::OPMisc& opMisc = *Sim.getOutputPlugin<dynamo::OPMisc>();
+  BOOST_CHECK_CLOSE(opMisc.getMFT(), expectedMFT, 1);
+
+  double Temperature = opMisc.getCurrentkT() / Sim.units.unitEnergy();
+  BOOST_CHECK_CLOSE(Temperature, 1.0, 0.000000001);
+
+  checkNeighbours(Sim);
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
+}
+
+BOOST_AUTO_TEST_CASE( Large_Size_Ratio )
+{
+  //Eight large particles with a 10:1 size ratio to the small
+  //particles, which are removed from the lattice around the large
+  //particles.
+  const double diamA = 0.2, diamB = 0.02;
+  std::vector<dynamo::Vector> positions;
+  for (int i(0); i < 8; ++i)
+    positions.push_back(dynamo::Vector((i & 1) ? 0.25 : -0.25, (i & 2) ? 0.25 : -0.25, (i & 4) ? 0.25 : -0.25));
+
+  for (const dynamo::Vector& site : getFCCSites())
+    {
+      bool overlap = false;
+      for (size_t i(0); i < 8; ++i)
+	overlap |= (site - positions[i]).nrm() < 0.6 * (diamA + diamB);
+      if (!overlap)
+	positions.push_back(site);
+    }
+
+  dynamo::Simulation Sim;
+  init(Sim, positions, 8, diamA, diamB);
+
+  Sim.endEventCount = 200000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+
+  checkNeighbours(Sim);
+
+  while (Sim.runSimulationStep()) {}
+
+  checkNeighbours(Sim);
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
+}
+
+BOOST_AUTO_TEST_CASE( Level_Ranges )
+{
+  const std::vector<dynamo::Vector> sites = getFCCSites();
+  const double diamA = 0.07, diamB = 0.035;
+
+  {
+    //Levels which are too short for their Interactions are rejected
+    dynamo::Simulation Sim;
+    init(Sim, sites, 100, diamA, diamB, 0.9);
+    BOOST_CHECK_THROW(Sim.initialise(), std::exception);
+  }
+
+  dynamo::Simulation Sim;
+  init(Sim, sites, 100, diamA, diamB);
+  Sim.initialise();
+
+  //Only the short range of the small level is guaranteed for every
+  //pair of particles, but the levels only need rebuilding once the
+  //Interactions outgrow them
+  const dynamo::GNeighbourList& nblist = dynamic_cast<const dynamo::GNeighbourList&>(*Sim.globals["SchedulerNBList"]);
+  BOOST_CHECK(nblist.getMaxSupportedInteractionLength() >= diamB);
+  BOOST_CHECK(nblist.getMaxSupportedInteractionLength() < diamA);
+  BOOST_CHECK(nblist.getRebuildRange() >= diamA);
+
+  //Growing the requested range (e.g., when compressing) grows every
+  //level
+  dynamic_cast<dynamo::GNeighbourList&>(*Sim.globals["SchedulerNBList"]).setMaxInteractionRange(1.5 * diamA);
+  BOOST_CHECK(nblist.getMaxSupportedInteractionLength() >= 1.5 * diamB);
+  BOOST_CHECK(nblist.getRebuildRange() >= 1.5 * diamA);
+}
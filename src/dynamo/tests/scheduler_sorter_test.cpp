@@ -12,15 +12,20 @@
 #include <dynamo/inputplugins/include.hpp>
 #include <dynamo/interactions/hardsphere.hpp>
 #include <dynamo/outputplugins/misc.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <iostream>
 #include <random>
 
 std::mt19937 RNG;
 typedef dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > DefaultSorter;
 
 template<class Scheduler, class Sorter>
-void runTest()
+void runTest(size_t threadCount = 0)
 {
   dynamo::Simulation Sim;
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(threadCount);
+  Sim.threadPool = &pool;
 
   RNG.seed(std::random_device()());
   Sim.ranGenerator.seed(std::random_device()());
@@ -67,3 +72,142 @@ BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_CBT_Sorter )
 BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_BoundedPQ_Sorter )
 { runTest<dynamo::SNeighbourList, dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > >(); }
 
+/* Builds the initial FEL of a hard sphere fluid on a FCC lattice,
+   and drains it, returning the events in the order they are popped.
+*/
+std::vector<std::pair<size_t, dynamo::Event> > initialFEL(size_t threadCount)
+{
+  dynamo::Simulation Sim;
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(threadCount);
+  Sim.threadPool = &pool;
+
+  std::mt19937 rng(1);
+  std::normal_distribution<double> normal(0, 1);
+
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  //The CBT sorter can be drained without triggering a rebuild
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::Scheduler>(new dynamo::SNeighbourList(&Sim, new dynamo::FELCBT()));
+  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(std::array<long, 3>{{8, 8, 8}}, dynamo::Vector(1, 1, 1), new dynamo::UParticle()));
+  packptr->initialise();
+  const std::vector<dynamo::Vector> sites = packptr->placeObjects(dynamo::Vector(0,0,0));
+  const double diam = std::cbrt(0.5 / sites.size());
+
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, diam, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+
+  for (const dynamo::Vector& site : sites)
+    Sim.particles.push_back(dynamo::Particle(site, dynamo::Vector{normal(rng), normal(rng), normal(rng)}, Sim.particles.size()));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+  Sim.initialise();
+
+  dynamo::FEL& sorter = *Sim.ptrScheduler->getSorter();
+  std::vector<std::pair<size_t, dynamo::Event> > events;
+  while (!sorter.empty())
+    {
+      sorter.sort();
+      const std::pair<size_t, dynamo::Event> next = sorter.next();
+      events.push_back(next);
+      sorter.popNextEvent();
+      sorter.update(next.first);
+    }
+  return events;
+}
+
+BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_BoundedPQ_Sorter_Concurrent_Rebuild )
+{
+  //The concurrently built FEL holds exactly the events of a serial
+  //rebuild
+  const std::vector<std::pair<size_t, dynamo::Event> > serial = initialFEL(0);
+  const std::vector<std::pair<size_t, dynamo::Event> > concurrent = initialFEL(2);
+  BOOST_CHECK(serial.size() > 2048);
+  BOOST_REQUIRE_EQUAL(concurrent.size(), serial.size());
+  for (size_t i(0); i < serial.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(concurrent[i].first, serial[i].first);
+      BOOST_CHECK(concurrent[i].second.type == serial[i].second.type);
+      BOOST_CHECK_EQUAL(concurrent[i].second.extraID, serial[i].second.extraID);
+      BOOST_CHECK_EQUAL(concurrent[i].second.dt, serial[i].second.dt);
+    }
+
+  //The simulation also runs normally from the concurrent rebuild
+  runTest<dynamo::SNeighbourList, dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > >(2);
+}
+
+BOOST_AUTO_TEST_CASE( Dumb_Scheduler_Ladder_Sorter )
+{ runTest<dynamo::SDumb, dynamo::FELLadder<dynamo::PELMinMax<3> > >(); }
+
+BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_Ladder_Sorter )
+{ runTest<dynamo::SNeighbourList, dynamo::FELLadder<dynamo::PELMinMax<3> > >(); }
+
+//A single inline event forces most events into the overflow storage
+BOOST_AUTO_TEST_CASE( Dumb_Scheduler_BoundedPQInline_Sorter )
+{ runTest<dynamo::SDumb, dynamo::FELBoundedPQ<dynamo::PELInline<1> > >(); }
+
+BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_BoundedPQInline_Sorter )
+{ runTest<dynamo::SNeighbourList, dynamo::FELBoundedPQ<dynamo::PELInline<4> > >(); }
+
+BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_LadderInline_Sorter )
+{ runTest<dynamo::SNeighbourList, dynamo::FELLadder<dynamo::PELInline<8> > >(); }
+
+/* A "hold model" run of a FEL: the next event is repeatedly removed
+   and its particle is given new events, as the Scheduler does after
+   each event. The popped events are returned in order.
+*/
+template<class Sorter>
+std::vector<std::pair<size_t, dynamo::Event> > holdModelFEL(const size_t N, const size_t events)
+{
+  std::mt19937 rng(1);
+  std::exponential_distribution<double> dtDist(1.0);
+  std::uniform_int_distribution<size_t> IDDist(0, N - 1);
+
+  Sorter sorter;
+  sorter.resize(N + 1);
+  for (size_t ID(0); ID < N; ++ID)
+    for (size_t i(0); i < 3; ++i)
+      sorter.push(dynamo::Event(dtDist(rng), dynamo::INTERACTION, IDDist(rng), 0), ID);
+  sorter.init();
+
+  std::vector<std::pair<size_t, dynamo::Event> > popped;
+  for (size_t i(0); i < events; ++i)
+    {
+      sorter.sort();
+      const std::pair<size_t, dynamo::Event> next = sorter.next();
+      popped.push_back(next);
+      sorter.stream(next.second.dt);
+      sorter.clearPEL(next.first);
+      for (size_t j(0); j < 3; ++j)
+	sorter.push(dynamo::Event(dtDist(rng), dynamo::INTERACTION, IDDist(rng), i), next.first);
+      sorter.update(next.first);
+    }
+  return popped;
+}
+
+BOOST_AUTO_TEST_CASE( FEL_Hold_Model )
+{
+  const size_t N = 1000, events = 20000;
+  const std::vector<std::pair<size_t, dynamo::Event> > CBT = holdModelFEL<dynamo::FELCBT>(N, events);
+  BOOST_REQUIRE_EQUAL(CBT.size(), events);
+
+  //The events are popped in time order
+  for (const std::pair<size_t, dynamo::Event>& event : CBT)
+    BOOST_CHECK(event.second.dt >= 0);
+
+  //Every sorter pops the same events, in the same order
+  const std::vector<std::pair<size_t, dynamo::Event> > boundedPQ = holdModelFEL<DefaultSorter>(N, events);
+  const std::vector<std::pair<size_t, dynamo::Event> > ladder = holdModelFEL<dynamo::FELLadder<dynamo::PELMinMax<3> > >(N, events);
+  for (const std::vector<std::pair<size_t, dynamo::Event> >* other : {&boundedPQ, &ladder})
+    {
+      BOOST_REQUIRE_EQUAL(other->size(), events);
+      for (size_t i(0); i < events; ++i)
+	{
+	  BOOST_CHECK_EQUAL((*other)[i].first, CBT[i].first);
+	  BOOST_CHECK_EQUAL((*other)[i].second.particle2ID, CBT[i].second.particle2ID);
+	  BOOST_CHECK_SMALL((*other)[i].second.dt - CBT[i].second.dt, 1e-10);
+	}
+    }
+}
@@ -170,3 +170,33 @@ BOOST_AUTO_TEST_CASE( Compression_Simulation )
   BOOST_CHECK_CLOSE(Sim.getPackingFraction(), Sim.getNumberDensity() * Sim.units.unitVolume() * M_PI / 6.0, 0.000000001);
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "After compression, there are more than one invalid states in the final configuration");
 }
+
+BOOST_AUTO_TEST_CASE( Capture_Map_Hash )
+{
+  dynamo::Simulation Sim;
+  init(Sim);
+
+  //Every map visited is stored by the plugin, so keep the run short
+  Sim.endEventCount = 5000;
+  Sim.addOutputPlugin("Misc");
+  Sim.addOutputPlugin("Contactmap:Interaction=Bulk");
+  Sim.initialise();
+  while (Sim.runSimulationStep(true)) {}
+
+  //The incrementally updated hash must match the hash of the same
+  //entries inserted into a new map in a different order
+  const dynamo::ICapture& captures = *std::dynamic_pointer_cast<dynamo::ICapture>(Sim.interactions["Bulk"]);
+  BOOST_CHECK(captures.size() > 0);
+  const dynamo::detail::CaptureMapKey key(captures);
+  dynamo::detail::CaptureMap rebuilt;
+  for (auto it = key.rbegin(); it != key.rend(); ++it)
+    rebuilt[it->first] = it->second;
+  BOOST_CHECK_EQUAL(rebuilt.hash(), captures.hash());
+  BOOST_CHECK(dynamo::detail::CaptureMapKey(rebuilt) == key);
+
+  //Releasing every pair returns the hash to that of an empty map
+  for (const auto& entry : key)
+    rebuilt[entry.first] = 0;
+  BOOST_CHECK(rebuilt.empty());
+  BOOST_CHECK_EQUAL(rebuilt.hash(), 0);
+}
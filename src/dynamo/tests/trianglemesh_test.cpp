@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE TriangleMesh_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/locals/trianglemesh.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <cmath>
+#include <random>
+
+std::mt19937 RNG;
+
+/* A triangle mesh which also calculates its events by testing
+   every triangle, as the mesh does when it has no BVH.
+*/
+class TestMesh: public dynamo::LTriangleMesh
+{
+public:
+  TestMesh(dynamo::Simulation* Sim, const std::vector<dynamo::Vector>& vertices, const std::vector<TriangleElements>& elements):
+    LTriangleMesh(Sim, 1.0, 1.0, "Sheet", new dynamo::IDRangeAll(Sim))
+  {
+    _vertices = vertices;
+    _elements = elements;
+  }
+
+  size_t getBVHSize() const { return _bvhNodes.size(); }
+
+  double bruteForceEvent(const dynamo::Particle& part) const
+  {
+    double tmin = HUGE_VAL;
+    for (const TriangleElements& elem : _elements)
+      tmin = std::min(tmin, Sim->dynamics->getSphereTriangleEvent(part, _vertices[std::get<0>(elem)], _vertices[std::get<1>(elem)],
+								 _vertices[std::get<2>(elem)], 0.5 * _diameter->getProperty(part)).first);
+    return tmin;
+  }
+};
+
+/* A corrugated sheet spanning the periodic box, with hard spheres
+   above and below it.
+*/
+TestMesh* init(dynamo::Simulation& Sim)
+{
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  Sim.primaryCellSize = dynamo::Vector(10, 10, 10);
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new dynamo::FELCBT()));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, 1.0, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+
+  //A 16x16 grid of quads gives 512 triangles, far more than fit in
+  //a single BVH leaf
+  const size_t n = 16;
+  std::vector<dynamo::Vector> vertices;
+  for (size_t i(0); i <= n; ++i)
+    for (size_t j(0); j <= n; ++j)
+      {
+	const double x = 10.0 * i / n - 5, z = 10.0 * j / n - 5;
+	vertices.push_back(dynamo::Vector(x, 0.5 * std::sin(M_PI * x / 5) * std::cos(M_PI * z / 5), z));
+      }
+
+  std::vector<std::tuple<size_t, size_t, size_t> > elements;
+  for (size_t i(0); i < n; ++i)
+    for (size_t j(0); j < n; ++j)
+      {
+	const size_t v = i * (n + 1) + j;
+	elements.push_back(std::make_tuple(v, v + 1, v + n + 2));
+	elements.push_back(std::make_tuple(v, v + n + 2, v + n + 1));
+      }
+
+  TestMesh* mesh = new TestMesh(&Sim, vertices, elements);
+  Sim.locals.push_back(dynamo::shared_ptr<dynamo::Local>(mesh));
+
+  std::normal_distribution<double> normal(0, 1);
+  for (const double y : {-2.5, 2.5})
+    for (const double x : {-3.75, -1.25, 1.25, 3.75})
+      for (const double z : {-3.75, -1.25, 1.25, 3.75})
+	Sim.particles.push_back(dynamo::Particle(dynamo::Vector(x, y, z), dynamo::Vector(normal(RNG), normal(RNG), normal(RNG)), Sim.particles.size()));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+  return mesh;
+}
+
+BOOST_AUTO_TEST_CASE( BVH_Events )
+{
+  dynamo::Simulation Sim;
+  TestMesh& mesh = *init(Sim);
+
+  Sim.endEventCount = 20000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  BOOST_CHECK(mesh.getBVHSize() > 1);
+  const double totalEinit = Sim.getOutputPlugin<dynamo::OPMisc>()->getTotalEnergy();
+
+  //The events found using the BVH must match testing every
+  //triangle. Particles only see the triangles near their box, so a
+  //VIRTUAL event at the edge of the box is only valid if no triangle
+  //is hit before it.
+  size_t wallEvents = 0, virtualEvents = 0;
+  while (Sim.runSimulationStep())
+    if (!(Sim.eventCount % 10))
+      {
+	Sim.dynamics->updateAllParticles();
+	for (const dynamo::Particle& part : Sim.particles)
+	  {
+	    const dynamo::LocalEvent event = mesh.getEvent(part);
+	    const double bruteForce = mesh.bruteForceEvent(part);
+	    if (event.getType() == dynamo::VIRTUAL)
+	      {
+		++virtualEvents;
+		BOOST_CHECK(bruteForce >= event.getdt());
+	      }
+	    else
+	      {
+		++wallEvents;
+		BOOST_CHECK_EQUAL(event.getdt(), bruteForce);
+	      }
+	  }
+      }
+
+  BOOST_CHECK(wallEvents > 0);
+  BOOST_CHECK(virtualEvents > 0);
+
+  const double totalEend = Sim.getOutputPlugin<dynamo::OPMisc>()->getTotalEnergy();
+  BOOST_CHECK_CLOSE(totalEinit, totalEend, 1e-8);
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than one invalid states in the final configuration");
+}
@@ -0,0 +1,265 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/exception.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <bzlib.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace magnet {
+  namespace compression {
+    namespace detail {
+      /*! \brief Compress a block of data into a complete bzip2
+          stream. */
+      inline void bzip2_compress_block(const char* data, size_t size, std::string& output, int level)
+      {
+	//This is the worst case output size given in the libbz2 manual
+	unsigned int outSize = size + size / 100 + 600;
+	output.resize(outSize);
+	int err = BZ2_bzBuffToBuffCompress(&output[0], &outSize, const_cast<char*>(data), size, level, 0, 0);
+	if (err != BZ_OK)
+	  M_throw() << "libbz2 failed to compress a block, error code = " << err;
+	output.resize(outSize);
+      }
+
+      /*! \brief Decompress one or more concatenated bzip2 streams.
+
+	\return False if the data was not a whole number of valid
+	streams.
+       */
+      inline bool bzip2_decompress_streams(const char* data, size_t size, std::string& output)
+      {
+	const size_t chunk = 1 << 20;
+	bz_stream stream;
+	while (size)
+	  {
+	    std::memset(&stream, 0, sizeof(bz_stream));
+	    if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK)
+	      M_throw() << "Failed to initialise libbz2";
+
+	    stream.next_in = const_cast<char*>(data);
+	    stream.avail_in = size;
+
+	    int err = BZ_OK;
+	    while (err == BZ_OK)
+	      {
+		const size_t oldSize = output.size();
+		output.resize(oldSize + chunk);
+		stream.next_out = &output[oldSize];
+		stream.avail_out = chunk;
+		err = BZ2_bzDecompress(&stream);
+		output.resize(output.size() - stream.avail_out);
+		if ((err == BZ_OK) && !stream.avail_in && stream.avail_out)
+		  err = BZ_UNEXPECTED_EOF;
+	      }
+
+	    BZ2_bzDecompressEnd(&stream);
+	    if (err != BZ_STREAM_END) return false;
+
+	    //Move onto the next stream, if there is one
+	    data += size - stream.avail_in;
+	    size = stream.avail_in;
+	  }
+	return true;
+      }
+
+      /*! \brief Test if a stream header starts at the passed
+	  location.
+
+	A stream starts with "BZh" and the block size digit, followed
+	by either the magic number of a block or of the end of the
+	stream. This is 10 bytes in total, so false positives within
+	the compressed data are very unlikely, but possible.
+       */
+      inline bool bzip2_stream_start(const char* data, size_t size)
+      {
+	static const char block_magic[6] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+	static const char eos_magic[6] = {0x17, 0x72, 0x45, 0x38, 0x50, char(0x90)};
+	return (size >= 10) && (data[0] == 'B') && (data[1] == 'Z') && (data[2] == 'h')
+	  && (data[3] >= '1') && (data[3] <= '9')
+	  && (!std::memcmp(data + 4, block_magic, 6) || !std::memcmp(data + 4, eos_magic, 6));
+      }
+    }
+
+    /*! \brief Decompress bzip2 data using a ThreadPool.
+
+      Data compressed by \ref bzip2_parallel_sink (or pbzip2) is a
+      concatenation of independent bzip2 streams. The data is split at
+      the stream headers and each stream is decompressed as a separate
+      task. Standard single stream files, or any data where the split
+      turns out to be invalid, are decompressed serially.
+
+      \param output The decompressed data is appended to this string.
+     */
+    inline void bzip2_parallel_decompress(const char* data, size_t size, std::string& output, thread::ThreadPool& pool)
+    {
+      if (!detail::bzip2_stream_start(data, size))
+	M_throw() << "The data is not bzip2 compressed";
+
+      std::vector<size_t> starts(1, 0);
+      if (pool.getThreadCount())
+	for (const char* ptr = static_cast<const char*>(std::memchr(data + 1, 'B', size - 1)); ptr;
+	     ptr = static_cast<const char*>(std::memchr(ptr + 1, 'B', data + size - ptr - 1)))
+	  if (detail::bzip2_stream_start(ptr, data + size - ptr))
+	    starts.push_back(ptr - data);
+      starts.push_back(size);
+
+      if (starts.size() > 2)
+	{
+	  const size_t streams = starts.size() - 1;
+	  std::vector<std::string> outputs(streams);
+	  std::unique_ptr<bool[]> valid(new bool[streams]);
+	  for (size_t i(0); i < streams; ++i)
+	    pool.queueTask([&, i]() { valid[i] = detail::bzip2_decompress_streams(data + starts[i], starts[i+1] - starts[i], outputs[i]); });
+	  pool.wait();
+
+	  bool allValid = true;
+	  size_t total = output.size();
+	  for (size_t i(0); i < streams; ++i)
+	    {
+	      allValid &= valid[i];
+	      total += outputs[i].size();
+	    }
+
+	  if (allValid)
+	    {
+	      output.reserve(total);
+	      for (const std::string& stream : outputs)
+		output.append(stream);
+	      return;
+	    }
+	}
+
+      if (!detail::bzip2_decompress_streams(data, size, output))
+	M_throw() << "The bzip2 data is corrupt";
+    }
+
+    /*! \brief A boost::iostreams Sink which writes bzip2 compressed
+        data to a file, compressing blocks in parallel.
+
+      The data is split into fixed size blocks and each block is
+      compressed as an independent bzip2 stream, using the tasks of a
+      ThreadPool. The resulting file is a concatenation of bzip2
+      streams (the same layout as pbzip2), which can be read by any
+      bzip2 decompressor. Blocks are collected until there are two
+      for every thread in the pool, then compressed together and
+      written in order, so the memory use is bounded.
+
+      The data is only guaranteed to be written once the sink is
+      closed (i.e., the stream is closed or destroyed).
+     */
+    class bzip2_parallel_sink
+    {
+    public:
+      typedef char char_type;
+      struct category: boost::iostreams::sink_tag, boost::iostreams::closable_tag {};
+
+      /*! \param fileName The path of the file to write.
+	\param pool The ThreadPool to compress the blocks with.
+	\param level The bzip2 block size/compression level, [1,9].
+       */
+      bzip2_parallel_sink(const std::string& fileName, thread::ThreadPool& pool, int level = 9):
+	_impl(new Impl(fileName, pool, level))
+      {}
+
+      std::streamsize write(const char* s, std::streamsize n)
+      {
+	_impl->write(s, n);
+	return n;
+      }
+
+      void close() { _impl->close(); }
+
+    private:
+      /*! As boost::iostreams copies devices, the state is shared
+          between the copies. */
+      struct Impl
+      {
+	Impl(const std::string& fileName, thread::ThreadPool& pool, int level):
+	  _file(fileName.c_str(), std::ios::binary | std::ios::trunc),
+	  _pool(pool), _level(level), _blockSize(level * 100000), _closed(false)
+	{
+	  if (!_file)
+	    M_throw() << "Failed to open " << fileName << " for writing";
+	  _blocks.push_back(std::string());
+	  _blocks.back().reserve(_blockSize);
+	}
+
+	~Impl() { if (!_closed) try { close(); } catch (...) {} }
+
+	void write(const char* s, size_t n)
+	{
+	  while (n)
+	    {
+	      const size_t count = std::min(n, _blockSize - _blocks.back().size());
+	      _blocks.back().append(s, count);
+	      s += count;
+	      n -= count;
+
+	      if (_blocks.back().size() == _blockSize)
+		{
+		  if (_blocks.size() >= std::max(size_t(1), 2 * _pool.getThreadCount()))
+		    flush();
+		  _blocks.push_back(std::string());
+		  _blocks.back().reserve(_blockSize);
+		}
+	    }
+	}
+
+	void close()
+	{
+	  if (_closed) return;
+	  _closed = true;
+	  if (_blocks.back().empty()) _blocks.pop_back();
+	  flush();
+	  _file.close();
+	}
+
+	void flush()
+	{
+	  std::vector<std::string> outputs(_blocks.size());
+	  for (size_t i(0); i < _blocks.size(); ++i)
+	    _pool.queueTask([this, &outputs, i]() { detail::bzip2_compress_block(_blocks[i].data(), _blocks[i].size(), outputs[i], _level); });
+	  _pool.wait();
+
+	  for (const std::string& output : outputs)
+	    _file.write(output.data(), output.size());
+
+	  if (!_file)
+	    M_throw() << "Failed to write the compressed data";
+
+	  _blocks.clear();
+	}
+
+	std::ofstream _file;
+	thread::ThreadPool& _pool;
+	int _level;
+	size_t _blockSize;
+	bool _closed;
+	std::vector<std::string> _blocks;
+      };
+
+      std::shared_ptr<Impl> _impl;
+    };
+  }
+}
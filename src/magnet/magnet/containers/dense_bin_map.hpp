@@ -0,0 +1,225 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace magnet {
+  namespace containers {
+    namespace detail {
+      /*! \brief A class used to provide iterators for DenseBinMap,
+	which visit the used bins in order of their key. */
+      template<class Map, class Value, class SparseIterator>
+      class DenseBinIterator
+      {
+      public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef typename Map::value_type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef Value* pointer;
+	typedef Value& reference;
+
+	DenseBinIterator(): _map(NULL), _index(0) {}
+	DenseBinIterator(Map* map, size_t index, SparseIterator it): _map(map), _index(index), _it(it) {}
+
+	template<class M2, class V2, class I2>
+	DenseBinIterator(const DenseBinIterator<M2, V2, I2>& o): _map(o._map), _index(o._index), _it(o._it) {}
+
+	DenseBinIterator& operator++() {
+	  if (_map->_sparse)
+	    ++_it;
+	  else
+	    _index = _map->nextUsed(_index + 1);
+	  return *this;
+	}
+
+	DenseBinIterator operator++(int) { DenseBinIterator tmp(*this); ++(*this); return tmp; }
+	reference operator*() const { return _map->_sparse ? _it->second : _map->_bins[_index]; }
+	pointer operator->() const { return &(operator*()); }
+	bool operator==(const DenseBinIterator& o) const { return (_index == o._index) && (_it == o._it); }
+	bool operator!=(const DenseBinIterator& o) const { return !(*this == o); }
+
+      private:
+	template<class M2, class V2, class I2> friend class DenseBinIterator;
+	Map* _map;
+	size_t _index;
+	SparseIterator _it;
+      };
+    }
+
+    /*! \brief A map from integer bin indices to values, stored in a
+      contiguous array.
+
+      Histograms are filled on hot paths (e.g., every event), where
+      the O(log N) lookup and scattered nodes of a std::map are
+      wasteful. This container instead stores the bins in a
+      std::vector starting at an offset bin, which grows (in either
+      direction, by doubling) to cover new bins. A lookup is then
+      just an index into the vector.
+
+      As with a std::map, only the bins which have been accessed
+      are visited when iterating, and they are visited in order of
+      their key. If the range of the bins would exceed MaxDenseBins,
+      (e.g., a single outlying value far from the rest) the
+      container falls back to storing the bins in a std::map.
+
+      \tparam T The type stored in each bin.
+      \tparam MaxDenseBins The largest range of bins stored densely.
+     */
+    template<class T, size_t MaxDenseBins = (size_t(1) << 20)>
+    class DenseBinMap
+    {
+      typedef std::map<long, std::pair<long, T> > SparseMap;
+
+    public:
+      typedef long key_type;
+      typedef T mapped_type;
+      typedef std::pair<long, T> value_type;
+      typedef detail::DenseBinIterator<DenseBinMap, value_type, typename SparseMap::iterator> iterator;
+      typedef detail::DenseBinIterator<const DenseBinMap, const value_type, typename SparseMap::const_iterator> const_iterator;
+
+      DenseBinMap(): _offset(0), _count(0), _sparse(false) {}
+
+      iterator begin() { return _sparse ? iterator(this, 0, _sparseBins.begin()) : iterator(this, nextUsed(0), _sparseBins.end()); }
+      iterator end() { return _sparse ? iterator(this, 0, _sparseBins.end()) : iterator(this, _bins.size(), _sparseBins.end()); }
+      const_iterator begin() const { return _sparse ? const_iterator(this, 0, _sparseBins.begin()) : const_iterator(this, nextUsed(0), _sparseBins.end()); }
+      const_iterator end() const { return _sparse ? const_iterator(this, 0, _sparseBins.end()) : const_iterator(this, _bins.size(), _sparseBins.end()); }
+
+      //! \brief The number of bins which have been accessed.
+      size_t size() const { return _sparse ? _sparseBins.size() : _count; }
+      bool empty() const { return size() == 0; }
+
+      //! \brief Test if the bins have fallen back to sparse storage.
+      bool isSparse() const { return _sparse; }
+
+      /*! \brief Access a bin, which is initialised using T() if it
+	has not been accessed before.
+       */
+      T& operator[](const long key)
+      {
+	if (!_sparse)
+	  {
+	    if ((key < _offset) || (key >= _offset + long(_bins.size())))
+	      grow(key);
+
+	    if (!_sparse)
+	      {
+		const size_t index = key - _offset;
+		if (!_used[index])
+		  {
+		    _used[index] = true;
+		    ++_count;
+		  }
+		return _bins[index].second;
+	      }
+	  }
+
+	typename SparseMap::iterator it = _sparseBins.find(key);
+	if (it == _sparseBins.end())
+	  it = _sparseBins.insert(std::make_pair(key, value_type(key, T()))).first;
+	return it->second.second;
+      }
+
+      //! \brief Removes all bins, returning to dense storage.
+      void clear()
+      {
+	_bins.clear();
+	_used.clear();
+	_sparseBins.clear();
+	_offset = 0;
+	_count = 0;
+	_sparse = false;
+      }
+
+    protected:
+      template<class M, class V, class I> friend class detail::DenseBinIterator;
+
+      //! \brief The first used bin at or after index.
+      size_t nextUsed(size_t index) const {
+	while ((index < _used.size()) && !_used[index]) ++index;
+	return index;
+      }
+
+      //! \brief Resize the dense storage to cover the bin key.
+      void grow(const long key)
+      {
+	//Only the span of the accessed bins counts against the limit,
+	//not the padding from earlier growth
+	long usedFirst = key, usedLast = key + 1;
+	if (_count)
+	  {
+	    size_t lastIndex = _used.size();
+	    while (!_used[lastIndex - 1]) --lastIndex;
+	    usedFirst = std::min(usedFirst, _offset + long(nextUsed(0)));
+	    usedLast = std::max(usedLast, _offset + long(lastIndex));
+	  }
+
+	if (size_t(usedLast - usedFirst) > MaxDenseBins)
+	  {
+	    //The range is pathological, so fall back to a map
+	    for (size_t i(0); i < _bins.size(); ++i)
+	      if (_used[i])
+		_sparseBins.insert(std::make_pair(_bins[i].first, _bins[i]));
+	    _bins.clear();
+	    _used.clear();
+	    _count = 0;
+	    _sparse = true;
+	    return;
+	  }
+
+	//Grow by at least doubling in the direction of the new key, to
+	//keep the insertion amortised, but never pad beyond the limit
+	const long growth = std::min(std::max(long(_bins.size()), long(16)),
+				     long(MaxDenseBins) - (usedLast - usedFirst));
+	long first = usedFirst, last = usedLast;
+	if (_count && (key < _offset))
+	  first -= growth;
+	else
+	  last += growth;
+
+	std::vector<value_type> bins;
+	bins.reserve(last - first);
+	for (long k(first); k < last; ++k)
+	  bins.push_back(value_type(k, T()));
+
+	std::vector<bool> used(last - first, false);
+	for (size_t i(0); i < _bins.size(); ++i)
+	  if (_used[i])
+	    {
+	      bins[i + (_offset - first)].second = _bins[i].second;
+	      used[i + (_offset - first)] = true;
+	    }
+
+	_bins.swap(bins);
+	_used.swap(used);
+	_offset = first;
+      }
+
+      std::vector<value_type> _bins;
+      std::vector<bool> _used;
+      SparseMap _sparseBins;
+      long _offset;
+      size_t _count;
+      bool _sparse;
+    };
+  }
+}
@@ -0,0 +1,239 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/exception.hpp>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace magnet {
+  namespace containers {
+    namespace detail {
+      /*! \brief A class used to provide iterators for FlatHashMap,
+	which skip the empty slots of the table. */
+      template<class Map, class Value>
+      class FlatHashIterator
+      {
+      public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef typename Map::value_type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef Value* pointer;
+	typedef Value& reference;
+
+	FlatHashIterator(): _map(NULL), _slot(0) {}
+	FlatHashIterator(Map* map, size_t slot): _map(map), _slot(slot) {}
+
+	template<class M2, class V2>
+	FlatHashIterator(const FlatHashIterator<M2, V2>& o): _map(o._map), _slot(o._slot) {}
+
+	FlatHashIterator& operator++() { _slot = _map->nextOccupied(_slot + 1); return *this; }
+	FlatHashIterator operator++(int) { FlatHashIterator tmp(*this); ++(*this); return tmp; }
+	reference operator*() const { return _map->_slots[_slot]; }
+	pointer operator->() const { return &_map->_slots[_slot]; }
+	bool operator==(const FlatHashIterator& o) const { return _slot == o._slot; }
+	bool operator!=(const FlatHashIterator& o) const { return _slot != o._slot; }
+
+      private:
+	template<class M2, class V2> friend class FlatHashIterator;
+	Map* _map;
+	size_t _slot;
+      };
+    }
+
+    /*! \brief A hash map for keys which are a single 64 bit word,
+      stored in one flat array using open addressing.
+
+      Unlike a std::unordered_map, there is no allocation per entry
+      and a lookup probes neighbouring slots of one array, so it is
+      much more compact and cache friendly for maps holding millions
+      of small entries. Collisions are resolved by linear probing and
+      entries are erased by shifting the following entries back (so
+      no "tombstones" are left behind).
+
+      Erasing or inserting an entry invalidates all iterators and
+      references to the entries of the map. The entries are iterated
+      over in the (arbitrary) order of their hash.
+
+      \tparam KeyType The key type, which must be convertible to and
+      from a uint64_t.
+
+      \tparam MappedType The type of the mapped values.
+
+      \tparam EmptyKey A key value which is never stored in the map,
+      used to mark the empty slots.
+    */
+    template<class KeyType, class MappedType, uint64_t EmptyKey = ~uint64_t(0)>
+    class FlatHashMap
+    {
+    public:
+      typedef KeyType key_type;
+      typedef MappedType mapped_type;
+      typedef std::pair<key_type, mapped_type> value_type;
+      typedef detail::FlatHashIterator<FlatHashMap, value_type> iterator;
+      typedef detail::FlatHashIterator<const FlatHashMap, const value_type> const_iterator;
+
+      FlatHashMap(): _count(0) {}
+
+      template<class InputIterator>
+      FlatHashMap(InputIterator first, InputIterator last): _count(0)
+      { for (; first != last; ++first) insert(*first); }
+
+      iterator begin() { return iterator(this, nextOccupied(0)); }
+      iterator end() { return iterator(this, _slots.size()); }
+      const_iterator begin() const { return const_iterator(this, nextOccupied(0)); }
+      const_iterator end() const { return const_iterator(this, _slots.size()); }
+
+      size_t size() const { return _count; }
+      bool empty() const { return _count == 0; }
+
+      //! \brief The number of slots in the table.
+      size_t capacity() const { return _slots.size(); }
+
+      iterator find(const key_type& key) { return iterator(this, findSlot(key)); }
+      const_iterator find(const key_type& key) const { return const_iterator(this, findSlot(key)); }
+      size_t count(const key_type& key) const { return findSlot(key) != _slots.size(); }
+
+      mapped_type& operator[](const key_type& key)
+      { return _slots[insertSlot(key)].second; }
+
+      std::pair<iterator, bool> insert(const value_type& value) {
+	const size_t oldcount = _count;
+	const size_t slot = insertSlot(value.first);
+	const bool inserted = (_count != oldcount);
+	if (inserted) _slots[slot].second = value.second;
+	return std::make_pair(iterator(this, slot), inserted);
+      }
+
+      //! \brief Erase an entry, returning the number of entries erased.
+      size_t erase(const key_type& key) {
+	size_t slot = findSlot(key);
+	if (slot == _slots.size()) return 0;
+
+	//Shift back any following entries which would no longer be
+	//reachable from their home slot
+	const size_t mask = _slots.size() - 1;
+	for (size_t next = (slot + 1) & mask; !isEmpty(next); next = (next + 1) & mask)
+	  {
+	    const size_t home = homeSlot(_slots[next].first);
+	    //Check if home lies cyclically in the range (slot, next]
+	    const bool reachable = (slot <= next)
+	      ? ((slot < home) && (home <= next))
+	      : ((slot < home) || (home <= next));
+	    if (!reachable)
+	      {
+		_slots[slot] = _slots[next];
+		slot = next;
+	      }
+	  }
+
+	_slots[slot] = emptyValue();
+	--_count;
+	return 1;
+      }
+
+      //! \brief Removes all entries, but keeps the allocated table.
+      void clear() {
+	for (value_type& val : _slots)
+	  val = emptyValue();
+	_count = 0;
+      }
+
+      //! \brief Make sure N entries can be held without a rehash.
+      void reserve(const size_t N) {
+	size_t newcapacity = 16;
+	while (newcapacity * 3 < N * 4) newcapacity *= 2;
+	if (newcapacity > _slots.size()) rehash(newcapacity);
+      }
+
+    protected:
+      template<class M, class V> friend class detail::FlatHashIterator;
+
+      static value_type emptyValue() { return value_type(key_type(EmptyKey), mapped_type()); }
+
+      bool isEmpty(const size_t slot) const { return uint64_t(_slots[slot].first) == EmptyKey; }
+
+      /*! \brief A 64 bit mixing function (from the MurmurHash3
+	finaliser), as the raw keys are often sequential and would
+	otherwise cluster together in the table. */
+      size_t homeSlot(const key_type& key) const {
+	uint64_t h = uint64_t(key);
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h & (_slots.size() - 1);
+      }
+
+      //! \brief The first occupied slot at or after slot.
+      size_t nextOccupied(size_t slot) const {
+	while ((slot < _slots.size()) && isEmpty(slot)) ++slot;
+	return slot;
+      }
+
+      //! \brief The slot of key, or _slots.size() if it is missing.
+      size_t findSlot(const key_type& key) const {
+	if (_count == 0) return _slots.size();
+	const size_t mask = _slots.size() - 1;
+	for (size_t slot = homeSlot(key); !isEmpty(slot); slot = (slot + 1) & mask)
+	  if (uint64_t(_slots[slot].first) == uint64_t(key))
+	    return slot;
+	return _slots.size();
+      }
+
+      //! \brief The slot of key, inserting a default entry if missing.
+      size_t insertSlot(const key_type& key) {
+#ifdef MAGNET_DEBUG
+	if (uint64_t(key) == EmptyKey) M_throw() << "Cannot insert the reserved empty key into a FlatHashMap";
+#endif
+	//Keep the load factor below 3/4
+	if ((_count + 1) * 4 > _slots.size() * 3)
+	  rehash(_slots.empty() ? 16 : 2 * _slots.size());
+
+	const size_t mask = _slots.size() - 1;
+	size_t slot = homeSlot(key);
+	for (; !isEmpty(slot); slot = (slot + 1) & mask)
+	  if (uint64_t(_slots[slot].first) == uint64_t(key))
+	    return slot;
+
+	_slots[slot].first = key;
+	++_count;
+	return slot;
+      }
+
+      void rehash(const size_t newcapacity) {
+	std::vector<value_type> oldslots(newcapacity, emptyValue());
+	oldslots.swap(_slots);
+
+	const size_t mask = _slots.size() - 1;
+	for (const value_type& val : oldslots)
+	  if (uint64_t(val.first) != EmptyKey)
+	    {
+	      size_t slot = homeSlot(val.first);
+	      while (!isEmpty(slot)) slot = (slot + 1) & mask;
+	      _slots[slot] = val;
+	    }
+      }
+
+      std::vector<value_type> _slots;
+      size_t _count;
+    };
+  }
+}
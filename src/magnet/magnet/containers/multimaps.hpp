@@ -21,6 +21,8 @@
 #pragma once
 
 #include <magnet/containers/iterator_pair.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace magnet {
   namespace containers {
@@ -57,6 +59,54 @@ namespace magnet {
       void clear() { _data.clear(); }
     };
 
+    /*! \brief This container roughly approximates a multimap
+      implementation but only stores the keys which have contents.
+
+      This is a sparse version of the Vector_Multimap, where the
+      contents of each key are stored in a hash map and are discarded
+      when they become empty. It should be used when the key range is
+      large but only a small fraction of the keys are in use at any
+      time.
+    */
+    template <typename InnerSet>
+    class Hash_Multimap {
+      std::unordered_map<size_t, InnerSet> _data;
+      static const InnerSet _empty;
+    public:
+      typedef typename InnerSet::const_iterator const_iterator;
+
+      void erase(size_t key, size_t value) {
+	auto it = _data.find(key);
+#ifdef MAGNET_DEBUG
+	if (it == _data.end()) M_throw() << "Erasing from an empty key (key=" << key << ")";
+#endif
+	it->second.erase(value);
+	if (it->second.empty())
+	  _data.erase(it);
+      }
+
+      void insert(size_t key, size_t value) {
+	_data[key].insert(value);
+      }
+
+      typedef magnet::containers::IteratorPairRange<const_iterator> RangeType;
+      RangeType getKeyContents(const size_t key) const {
+	auto it = _data.find(key);
+	if (it == _data.end())
+	  return RangeType(_empty.begin(), _empty.end());
+	return RangeType(it->second.begin(), it->second.end());
+      }
+
+      void resize(size_t keycount) {}
+
+      //! The number of keys which have contents.
+      size_t size() const { return _data.size(); }
+      void clear() { _data.clear(); }
+    };
+
+    template <typename InnerSet>
+    const InnerSet Hash_Multimap<InnerSet>::_empty;
+
 
     /*! \brief This container roughly approximates a multimap
       implementation but uses a set data structure.
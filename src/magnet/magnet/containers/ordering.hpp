@@ -218,5 +218,43 @@ namespace magnet {
 	return length;
       }
     };
+
+    /*! \brief An ordering which may be switched between Row-Major
+        and Morton ordering at run time.
+
+      Morton ordering improves the locality of neighbouring elements,
+      but the number of elements needed to store the array (see
+      length()) is padded up towards the next power of two in each
+      dimension.
+
+      \tparam NDim The dimensionality of the array.
+    */
+    template <size_t NDim>
+    class SwitchableOrdering : public detail::OrderingBase<NDim, SwitchableOrdering<NDim> > {
+      typedef typename detail::OrderingBase<NDim, SwitchableOrdering<NDim> > Base;
+    public:
+      typedef typename Base::ArrayType ArrayType;
+
+      SwitchableOrdering(): _rowMajor(), _morton(), _useMorton(false) {}
+
+      SwitchableOrdering(const ArrayType& dimensions, bool useMorton = false):
+	Base(dimensions), _rowMajor(dimensions), _morton(dimensions), _useMorton(useMorton) {}
+
+      size_t toIndex(const ArrayType& loc) const
+      { return _useMorton ? _morton.toIndex(loc) : _rowMajor.toIndex(loc); }
+
+      ArrayType toCoord(const size_t index) const
+      { return _useMorton ? _morton.toCoord(index) : _rowMajor.toCoord(index); }
+
+      /*! \brief How many elements are needed to store the array. */
+      size_t length() const { return _useMorton ? _morton.length() : _rowMajor.length(); }
+
+      bool isMorton() const { return _useMorton; }
+
+    private:
+      RowMajorOrdering<NDim> _rowMajor;
+      MortonOrdering<NDim> _morton;
+      bool _useMorton;
+    };
   }
 }
@@ -37,6 +37,71 @@ namespace magnet {
       return detail::nextEvent(f);
     }
 
+    /*! \brief A batched form of the ray-sphere intersection test.
+
+      This performs N ray-sphere tests at once. The rays are passed as
+      the scalar products of their origin R and direction V, which are
+      all that is needed to construct the overlap function. The
+      results are identical to the scalar ray_sphere test, but its
+      branches are evaluated for every ray and then selected between,
+      which allows the compiler to vectorise the loop (this requires
+      -fno-math-errno for the square root).
+
+      \tparam inverse If true, this returns the time the ray escapes the sphere (rather than enters).
+      \param R2 The values of R.nrm2() for each ray.
+      \param RV The values of (R | V) for each ray.
+      \param V2 The values of V.nrm2() for each ray.
+      \param sig The radius of the sphere for each ray.
+      \param dt The array the times until intersection are written to.
+      \param N The number of rays.
+    */
+    template<bool inverse = false>
+    inline void ray_sphere(const double* R2, const double* RV, const double* V2, const double* sig, double* dt, const size_t N)
+    {
+      //This is the PolynomialFunction<2> version of detail::nextEvent
+      //with the sign of the quadratic term known at compile time.
+      const double sign = inverse ? -1 : 1;
+      for (size_t i = 0; i < N; ++i)
+	{
+	  const double f0 = sign * (R2[i] - sig[i] * sig[i]);
+	  const double f1 = sign * (2 * RV[i]);
+	  const double f2 = sign * (2 * V2[i]);
+
+	  const double arg = f1 * f1 - 2 * f2 * f0;
+	  const double sqrtarg = std::sqrt(arg);
+
+	  //Every candidate solution is calculated, then clamped to
+	  //positive times (this is std::max(0.0, t) written as a
+	  //select).
+	  double t_linear = - f0 / f1;
+	  t_linear = (0.0 < t_linear) ? t_linear : 0.0;
+	  double t_stable = 2 * f0 / (-f1 + sqrtarg);
+	  t_stable = (0.0 < t_stable) ? t_stable : 0.0;
+	  double t_turning = - f1 / f2;
+	  t_turning = (0.0 < t_turning) ? t_turning : 0.0;
+	  double t_root = (-f1 - sqrtarg) / f2;
+	  t_root = (0.0 < t_root) ? t_root : 0.0;
+
+	  const bool receding = f1 >= 0;
+	  const bool noroots = arg <= 0;
+	  const double linear = receding ? HUGE_VAL : t_linear;
+
+	  double quadratic;
+	  if (inverse)
+	    {
+	      const double escaping = (f1 > 0) ? t_root : t_stable;
+	      quadratic = noroots ? t_turning : escaping;
+	    }
+	  else
+	    {
+	      const double approaching = noroots ? HUGE_VAL : t_stable;
+	      quadratic = receding ? HUGE_VAL : approaching;
+	    }
+
+	  dt[i] = (f2 == 0) ? linear : quadratic;
+	}
+    }
+
     /*! \brief A ray-sphere intersection test where the sphere
       diameter is growing linearly with time.
       
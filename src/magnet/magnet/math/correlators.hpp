@@ -19,6 +19,7 @@
 #include <magnet/math/vector.hpp>
 #include <magnet/exception.hpp>
 #include <boost/circular_buffer.hpp>
+#include <algorithm>
 #include <vector>
 #include <utility>
 #include <tuple>
@@ -437,6 +438,180 @@ namespace magnet {
       
       Container _correlators;
     };
+
+    /*! \brief A multiple-tau correlator of many channels of data,
+        sampled at regular intervals.
+
+	Unlike the Correlator class, which stores every sample over
+	the full length of the correlation, this class stores the
+	samples in a hierarchy of levels. Level \f$k\f$ holds the last
+	\f$p\f$ samples taken every \f$m^k\f$ pushes, where \f$p\f$
+	is the number of points and \f$m\f$ is the scaling. Each level
+	correlates its newest sample against its stored samples, giving
+	lags of \f$j\,m^k\f$. The lags which a finer level already
+	resolves are skipped (except on the first level).
+
+	The lags therefore grow logarithmically with time, so only
+	\f$p\f$ samples per decade of \f$m\f$ are stored and each
+	push costs \f$\mathcal{O}(p\,m/(m-1))\f$ correlations per
+	channel. The samples are not block averaged when passed to the
+	coarser levels, so each lag is an exact correlation over fewer
+	time origins.
+
+	The channels are split into contiguous groups (e.g., species)
+	and the correlation is averaged over the channels of each
+	group. The inner loop runs over the contiguous channels of a
+	group, so it is simple for the compiler to vectorise.
+
+	\tparam T The type of the sampled values.
+
+	\tparam Correlation A functor taking the value at the time
+	origin and the value after the lag, returning the double to be
+	averaged (e.g., the squared displacement).
+     */
+    template<class T, class Correlation>
+    class MultiTauCorrelator
+    {
+    public:
+      /*! \brief Resets the correlator before data collection.
+
+	\param groupEnds The channel index which ends each group. The
+	last entry is the total number of channels.
+
+	\param points The number of samples stored by each level.
+
+	\param scaling The factor by which the sample interval grows
+	between levels. This must divide points.
+       */
+      void resize(const std::vector<size_t>& groupEnds, size_t points = 16, size_t scaling = 2)
+      {
+	if ((scaling < 2) || (points < scaling) || (points % scaling))
+	  M_throw() << "MultiTauCorrelator requires a scaling of at least 2 which divides the number of points, points=" << points
+		    << ", scaling=" << scaling;
+
+	_groupEnds = groupEnds;
+	_channels = _groupEnds.empty() ? 0 : _groupEnds.back();
+	_points = points;
+	_scaling = scaling;
+	clear();
+      }
+
+      //! \brief Remove all samples and collected data.
+      void clear()
+      {
+	_levels.clear();
+	_pushes = 0;
+      }
+
+      /*! \brief Add a new sample of every channel to the correlator.
+
+	\param sample The values of the channels, in channel order.
+       */
+      void push(const std::vector<T>& sample)
+      {
+#ifdef MAGNET_DEBUG
+	if (sample.size() != _channels)
+	  M_throw() << "Sample has " << sample.size() << " channels, expected " << _channels;
+#endif
+	size_t stride = 1;
+	for (size_t k(0); ; ++k)
+	  {
+	    //New levels are created the first time they are sampled,
+	    //except at the very first sample
+	    if (k == _levels.size())
+	      {
+		if (_pushes == 0 && k > 0) break;
+		_levels.push_back(Level(_points, _channels, _groupEnds.size()));
+	      }
+
+	    Level& level = _levels[k];
+	    level._head = (level._head + 1) % _points;
+	    std::copy(sample.begin(), sample.end(), level._samples.begin() + level._head * _channels);
+	    level._count = std::min(level._count + 1, _points);
+	    correlate(level, (k == 0) ? 0 : _points / _scaling);
+
+	    stride *= _scaling;
+	    if (_pushes % stride) break;
+	  }
+	++_pushes;
+      }
+
+      /*! \brief The returned data type for the
+          getAveragedCorrelator() function.
+       */
+      struct Data
+      {
+	Data(size_t l, size_t sc, double v): lag(l), sample_count(sc), value(v) {}
+
+	//! \brief The lag, in units of the interval between pushes.
+	size_t lag;
+	size_t sample_count;
+	double value;
+      };
+
+      /*! \brief The correlation of a group at every lag collected
+          so far, averaged over the time origins and the channels of
+          the group.
+       */
+      std::vector<Data> getAveragedCorrelator(const size_t group) const
+      {
+	const size_t groupSize = _groupEnds[group] - ((group == 0) ? 0 : _groupEnds[group - 1]);
+	std::vector<Data> avg_correlator;
+	size_t stride = 1;
+	for (size_t k(0); k < _levels.size(); ++k, stride *= _scaling)
+	  for (size_t j((k == 0) ? 0 : _points / _scaling); j < _points; ++j)
+	    if (_levels[k]._origins[j])
+	      avg_correlator.push_back(Data(j * stride, _levels[k]._origins[j], 
+					    _levels[k]._sums[j * _groupEnds.size() + group] / (_levels[k]._origins[j] * double(groupSize))));
+	return avg_correlator;
+      }
+
+      //! \brief The number of samples pushed into the correlator.
+      size_t getPushCount() const { return _pushes; }
+
+    protected:
+      struct Level
+      {
+	Level(size_t points, size_t channels, size_t groups):
+	  _samples(points * channels), _sums(points * groups, 0), _origins(points, 0),
+	  _head(points - 1), _count(0) {}
+
+	//! \brief The stored samples, each holding every channel.
+	std::vector<T> _samples;
+	//! \brief The summed correlations, indexed by lag then group.
+	std::vector<double> _sums;
+	//! \brief The number of time origins collected for each lag.
+	std::vector<size_t> _origins;
+	size_t _head;
+	size_t _count;
+      };
+
+      void correlate(Level& level, const size_t jmin)
+      {
+	const Correlation correlation = Correlation();
+	const T* newest = &level._samples[level._head * _channels];
+	for (size_t j(jmin); j < level._count; ++j)
+	  {
+	    const T* origin = &level._samples[((level._head + _points - j) % _points) * _channels];
+	    size_t start = 0;
+	    for (size_t g(0); g < _groupEnds.size(); ++g)
+	      {
+		double sum = 0;
+		for (size_t i(start); i < _groupEnds[g]; ++i)
+		  sum += correlation(origin[i], newest[i]);
+		level._sums[j * _groupEnds.size() + g] += sum;
+		start = _groupEnds[g];
+	      }
+	    ++level._origins[j];
+	  }
+      }
+
+      std::vector<Level> _levels;
+      std::vector<size_t> _groupEnds;
+      size_t _channels;
+      size_t _points;
+      size_t _scaling;
+      size_t _pushes;
+    };
   }
 }
-
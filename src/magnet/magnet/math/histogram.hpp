@@ -17,14 +17,20 @@
 
 #pragma once
 #include <magnet/containers/fuzzy_array.hpp>
+#include <magnet/containers/dense_bin_map.hpp>
 #include <magnet/xmlwriter.hpp>
 
 namespace magnet {
   namespace math {
+    /*! \brief A histogram of samples.
+
+      The bins are stored in a magnet::containers::DenseBinMap, so
+      adding a sample is just an index into an array.
+     */
     template<bool shiftBin=false>
-    class Histogram : public magnet::containers::FuzzyArray<unsigned long, shiftBin>
+    class Histogram : public magnet::containers::FuzzyArray<unsigned long, shiftBin, magnet::containers::DenseBinMap<unsigned long> >
     {
-      typedef typename magnet::containers::FuzzyArray<unsigned long,shiftBin> Container;
+      typedef typename magnet::containers::FuzzyArray<unsigned long, shiftBin, magnet::containers::DenseBinMap<unsigned long> > Container;
 
     public:
       Histogram(double binwidth):
@@ -73,10 +79,13 @@ namespace magnet {
       unsigned long sampleCount;
     };
 
+    /*! \brief A histogram of weighted samples, stored as in
+        Histogram.
+     */
     template<bool shiftBin=false>
-    class HistogramWeighted: public magnet::containers::FuzzyArray<double,shiftBin>
+    class HistogramWeighted: public magnet::containers::FuzzyArray<double, shiftBin, magnet::containers::DenseBinMap<double> >
     {
-      typedef magnet::containers::FuzzyArray<double> Container;
+      typedef magnet::containers::FuzzyArray<double, shiftBin, magnet::containers::DenseBinMap<double> > Container;
     public:
       HistogramWeighted(double binwidth):
 	Container(binwidth),
@@ -102,7 +111,7 @@ namespace magnet {
 	    << magnet::xml::attr("BinWidth") << Container::getBinWidth() * scalex;
   
 	double avgSum = 0.0;
-	for (const Container::value_type &p1 : *this)
+	for (const typename Container::value_type &p1 : *this)
 	  avgSum += static_cast<double>(p1.first + 0.5 * shiftBin) * p1.second;
   
 	XML << magnet::xml::attr("AverageVal")
@@ -110,7 +119,7 @@ namespace magnet {
 	    << magnet::xml::chardata();
   
 	//This gives mathmatically correct but not really pretty
-	for (const Container::value_type &p1 : *this)
+	for (const typename Container::value_type &p1 : *this)
 	  XML << (p1.first + 0.5 * shiftBin) * Container::getBinWidth() * scalex << " "
 	      << static_cast<double>(p1.second)
 	  / (Container::getBinWidth() * sampleCount * scalex) << "\n";
@@ -129,7 +138,7 @@ namespace magnet {
 	    << magnet::xml::attr("BinWidth") << Container::getBinWidth() * scalex;
   
 	double avgSum = 0.0;
-	for (const Container::value_type &p1 : *this)
+	for (const typename Container::value_type &p1 : *this)
 	  avgSum += static_cast<double>(p1.first + 0.5 * shiftBin)* p1.second;
   
 	XML << magnet::xml::attr("AverageVal")
@@ -137,7 +146,7 @@ namespace magnet {
 	    << magnet::xml::chardata();
     
 	//This one gives histograms usable by the reweight program
-	for (const Container::value_type &p1 : *this)
+	for (const typename Container::value_type &p1 : *this)
 	  XML << (p1.first + 0.5 * shiftBin) * Container::getBinWidth() * scalex << " " 
 	      << static_cast<double>(p1.second)
 	  / (Container::getBinWidth() * sampleCount * scalex) << "\n";
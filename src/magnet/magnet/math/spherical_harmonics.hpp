@@ -0,0 +1,150 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <complex>
+#include <vector>
+#include <cmath>
+
+namespace magnet {
+  namespace math {
+    /*! \brief Sums the spherical harmonics \f$Y_l^m\f$ over blocks of
+        directions, using recurrence relations.
+
+	Evaluating each \f$Y_l^m\f$ separately (e.g., with
+	boost::math::spherical_harmonic) requires the angles of each
+	direction and recomputes the associated Legendre polynomials
+	for every \f$(l,m)\f$ pair. Instead, this class evaluates every
+	\f$Y_l^m\f$ with \f$l<L\f$ directly from the components of the
+	unit vectors, using
+	\f[
+	Y_l^m = \bar{Q}_l^m(\cos\theta)\,(\sin\theta\,e^{i\phi})^m
+	\f]
+	where \f$\bar{Q}_l^m\f$ is a normalised polynomial generated
+	by the standard three-term recurrence in \f$l\f$, and
+	\f$\sin\theta\,e^{i\phi}\f$ is just the transverse part of the
+	unit vector. The inner loops all run over the block of
+	directions, so they are simple for the compiler to vectorise.
+
+	The normalisation and phase (Condon-Shortley) match
+	boost::math::spherical_harmonic. Only the \f$m\ge0\f$ terms are
+	stored, as \f$Y_l^{-m}=(-1)^m\,\overline{Y_l^m}\f$.
+
+	An instance holds scratch space for the recurrence, so each
+	thread requires its own.
+     */
+    class SphericalHarmonicSum
+    {
+    public:
+      /*! \brief Constructor.
+	\param L The number of orders calculated, so \f$0\le l<L\f$.
+       */
+      SphericalHarmonicSum(size_t L):
+	_L(L), _a(size()), _b(size()), _diagonal(L)
+      {
+	for (size_t m(0); m < _L; ++m)
+	  {
+	    _diagonal[m] = (m == 0) ? 1.0 / std::sqrt(4.0 * M_PI)
+	      : - std::sqrt((2.0 * m + 1.0) / (2.0 * m)) * _diagonal[m - 1];
+
+	    for (size_t l(m + 1); l < _L; ++l)
+	      {
+		const double l2 = double(l) * l, m2 = double(m) * m, lm2 = double(l - 1) * (l - 1);
+		_a[index(l, m)] = std::sqrt((4.0 * l2 - 1.0) / (l2 - m2));
+		_b[index(l, m)] = std::sqrt((lm2 - m2) / (4.0 * lm2 - 1.0));
+	      }
+	  }
+      }
+
+      //! \brief The index of the \f$(l,m)\f$ term, for \f$0\le m\le l\f$.
+      static size_t index(size_t l, size_t m) { return l * (l + 1) / 2 + m; }
+
+      //! \brief The number of stored terms.
+      size_t size() const { return index(_L, 0); }
+
+      size_t getL() const { return _L; }
+
+      /*! \brief Add \f$\sum_j Y_l^m(\hat{\boldsymbol r}_j)\f$ to sums.
+
+	The polar axis of the harmonics is the first component. The
+	directions must be unit vectors.
+
+	\param z The component of each direction along the polar axis.
+	\param x The first transverse component of each direction.
+	\param y The second transverse component of each direction.
+	\param n The number of directions.
+	\param sums The sums, indexed by index(l, m), to add to.
+       */
+      void accumulate(const double* z, const double* x, const double* y, const size_t n, std::complex<double>* sums)
+      {
+	_re.assign(n, 1.0);
+	_im.assign(n, 0.0);
+	_q0.resize(n);
+	_q1.resize(n);
+
+	for (size_t m(0); m < _L; ++m)
+	  {
+	    //Raise the transverse part to the power m
+	    if (m)
+	      for (size_t j(0); j < n; ++j)
+		{
+		  const double re = _re[j] * x[j] - _im[j] * y[j];
+		  _im[j] = _re[j] * y[j] + _im[j] * x[j];
+		  _re[j] = re;
+		}
+
+	    for (size_t l(m); l < _L; ++l)
+	      {
+		double* q0 = _q0.data();
+		double* q1 = _q1.data();
+		if (l == m)
+		  for (size_t j(0); j < n; ++j)
+		    {
+		      q0[j] = 0;
+		      q1[j] = _diagonal[m];
+		    }
+		else
+		  {
+		    const double a = _a[index(l, m)], b = _b[index(l, m)];
+		    for (size_t j(0); j < n; ++j)
+		      {
+			const double q = a * (z[j] * q1[j] - b * q0[j]);
+			q0[j] = q1[j];
+			q1[j] = q;
+		      }
+		  }
+
+		double sumRe = 0, sumIm = 0;
+		for (size_t j(0); j < n; ++j)
+		  {
+		    sumRe += q1[j] * _re[j];
+		    sumIm += q1[j] * _im[j];
+		  }
+		sums[index(l, m)] += std::complex<double>(sumRe, sumIm);
+	      }
+	  }
+      }
+
+    private:
+      size_t _L;
+      std::vector<double> _a;
+      std::vector<double> _b;
+      std::vector<double> _diagonal;
+      std::vector<double> _re, _im, _q0, _q1;
+    };
+  }
+}
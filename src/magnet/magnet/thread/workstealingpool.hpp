@@ -0,0 +1,537 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file workstealingpool.hpp
+ * \brief Contains the definition of WorkStealingPool
+ */
+
+#pragma once
+
+#include <magnet/thread/threadgroup.hpp>
+#include <magnet/exception.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+
+namespace magnet {
+  namespace thread {
+    /*! \brief A Chase-Lev work-stealing deque.
+
+      The owning thread pushes and pops items at the bottom of the
+      deque, while any other thread may steal items from the top. No
+      locks are taken; pop and steal only contend (through a single
+      compare and swap) when one item is left. This is the weak memory
+      model version of the algorithm given by Lê et al., "Correct and
+      Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+
+      The storage grows as needed. Old arrays may still be read by a
+      thief, so they are only freed when the deque is destroyed.
+
+      \tparam T A type which is trivially copyable (e.g., a pointer).
+     */
+    template<class T>
+    class WorkStealingDeque
+    {
+      class Array
+      {
+      public:
+	Array(size_t logSize):
+	  _logSize(logSize), _mask((size_t(1) << logSize) - 1),
+	  _data(new std::atomic<T>[_mask + 1])
+	{}
+
+	size_t size() const { return _mask + 1; }
+
+	T get(int64_t i) const { return _data[i & _mask].load(std::memory_order_relaxed); }
+
+	void put(int64_t i, T x) { _data[i & _mask].store(x, std::memory_order_relaxed); }
+
+	Array* grow(int64_t bottom, int64_t top) const
+	{
+	  Array* newArray = new Array(_logSize + 1);
+	  for (int64_t i = top; i != bottom; ++i)
+	    newArray->put(i, get(i));
+	  return newArray;
+	}
+
+      private:
+	size_t _logSize;
+	size_t _mask;
+	std::unique_ptr<std::atomic<T>[]> _data;
+      };
+
+    public:
+      WorkStealingDeque(size_t logSize = 8):
+	_top(0), _bottom(0), _array(new Array(logSize))
+      { _arrays.emplace_back(_array.load(std::memory_order_relaxed)); }
+
+      /*! \brief Add an item to the bottom of the deque (owner only). */
+      void push(T x)
+      {
+	int64_t b = _bottom.load(std::memory_order_relaxed);
+	int64_t t = _top.load(std::memory_order_acquire);
+	Array* a = _array.load(std::memory_order_relaxed);
+	if (b - t > int64_t(a->size()) - 1)
+	  {
+	    a = a->grow(b, t);
+	    _arrays.emplace_back(a);
+	    _array.store(a, std::memory_order_release);
+	  }
+	a->put(b, x);
+	_bottom.store(b + 1, std::memory_order_release);
+      }
+
+      /*! \brief Take the most recently pushed item (owner only).
+
+	\return false if the deque was empty.
+       */
+      bool pop(T& x)
+      {
+	int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+	Array* a = _array.load(std::memory_order_relaxed);
+	_bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = _top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	  {
+	    //Empty
+	    _bottom.store(b + 1, std::memory_order_relaxed);
+	    return false;
+	  }
+
+	x = a->get(b);
+	if (t == b)
+	  {
+	    //Last item, race any thieves for it
+	    bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	    _bottom.store(b + 1, std::memory_order_relaxed);
+	    return won;
+	  }
+	return true;
+      }
+
+      /*! \brief Take the oldest item in the deque (any thread).
+
+	\return false if the deque was empty, or the item was taken by
+	another thread.
+       */
+      bool steal(T& x)
+      {
+	int64_t t = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = _bottom.load(std::memory_order_acquire);
+	if (t >= b) return false;
+
+	Array* a = _array.load(std::memory_order_acquire);
+	x = a->get(t);
+	return _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      }
+
+      bool empty() const
+      { return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed); }
+
+    private:
+      WorkStealingDeque(const WorkStealingDeque&);
+      WorkStealingDeque& operator=(const WorkStealingDeque&);
+
+      std::atomic<int64_t> _top;
+      std::atomic<int64_t> _bottom;
+      std::atomic<Array*> _array;
+      //! \brief Every array allocated (only accessed by the owner).
+      std::vector<std::unique_ptr<Array> > _arrays;
+    };
+
+    /*! \brief A pool of worker threads which balance their tasks
+      through work stealing.
+
+      This has the same interface as \ref ThreadPool, but each worker
+      has its own \ref WorkStealingDeque of tasks. A task queued by a
+      running task goes onto its worker's deque without taking any
+      lock, and idle workers steal from the other deques. Tasks queued
+      from outside the pool are placed in a shared queue, which
+      workers drain in batches (a share of the queue per worker), so
+      the lock is taken a few times per batch of tasks rather than once
+      per task.
+
+      Like \ref ThreadPool, in 0 thread mode the tasks are executed by
+      the controlling process when it enters wait(). wait() must not
+      be called from within a task.
+     */
+    class WorkStealingPool
+    {
+      typedef std::function<void()> Task;
+
+      struct Worker
+      {
+	WorkStealingDeque<Task*> tasks;
+	std::mt19937 RNG;
+      };
+
+    public:
+      /*! \brief Default Constructor
+
+        This initialises the pool to 0 threads
+       */
+      inline WorkStealingPool():
+	_pending(0),
+	_sleeping(0),
+	_exception_flag(false),
+	_stop_flag(false)
+      {}
+
+      /*! \brief Destructor
+
+        Join all threads in the pool. The threads only exit once there
+        are no tasks left to execute.
+       */
+      inline ~WorkStealingPool() throw()
+      {
+	stop();
+	for (Task* task : _injected)
+	  delete task;
+      }
+
+      /*! \brief Set the number of threads in the pool.
+
+	All current threads are stopped, once the queued tasks are
+	complete, before the new threads are started.
+       */
+      inline void setThreadCount(size_t x)
+      {
+	if (x == _threads.size()) return;
+
+	stop();
+	_stop_flag = false;
+
+	_workers.clear();
+	for (size_t i(0); i < x; ++i)
+	  {
+	    _workers.emplace_back(new Worker);
+	    _workers.back()->RNG.seed(i);
+	  }
+
+	for (size_t i(0); i < x; ++i)
+	  _threads.create_thread(std::function<void()>(std::bind(&WorkStealingPool::beginThread, this, i)));
+      }
+
+      /*! \brief The current number of threads in the pool */
+      inline size_t getThreadCount() const { return _threads.size(); }
+
+      /*! \brief Queue a task for execution.
+
+	If called from within a task running on this pool, the task is
+	pushed onto the current worker's deque without locking.
+       */
+      inline void queueTask(std::function<void()>&& threadfunc)
+      {
+	_pending.fetch_add(1, std::memory_order_relaxed);
+	Task* task = new Task(std::move(threadfunc));
+
+	if (currentPool() == this)
+	  {
+	    _workers[currentWorker()]->tasks.push(task);
+	    wakeWorkers(false);
+	    return;
+	  }
+
+	{
+	  std::lock_guard<std::mutex> lock(_mutex);
+	  _injected.push_back(task);
+	}
+	wakeWorkers(false);
+      }
+
+      /*! \brief Queue a batch of tasks for execution.
+
+	The passed vector is emptied.
+       */
+      inline void queueTasks(std::vector<std::function<void()> >& threadfuncs)
+      {
+	if (threadfuncs.empty()) return;
+
+	_pending.fetch_add(threadfuncs.size(), std::memory_order_relaxed);
+
+	if (currentPool() == this)
+	  {
+	    for (auto& func : threadfuncs)
+	      _workers[currentWorker()]->tasks.push(new Task(std::move(func)));
+	  }
+	else
+	  {
+	    std::lock_guard<std::mutex> lock(_mutex);
+	    for (auto& func : threadfuncs)
+	      _injected.push_back(new Task(std::move(func)));
+	  }
+	threadfuncs.clear();
+	wakeWorkers(true);
+      }
+
+      /*! \brief Wait for all tasks to complete.
+
+        If there are no threads in the pool then this function will
+        actually make the waiting/mother process perform the tasks
+        (including any tasks that they queue).
+       */
+      inline void wait()
+      {
+	if (_threads.size())
+	  {
+	    std::unique_lock<std::mutex> lock(_mutex);
+	    while (_pending.load())
+	      _done_condition.wait(lock);
+	  }
+	else
+	  {
+	    std::unique_lock<std::mutex> lock(_mutex);
+	    while (!_injected.empty())
+	      {
+		Task* task = _injected.front();
+		_injected.pop_front();
+		lock.unlock();
+		runTask(task);
+		lock.lock();
+	      }
+	  }
+
+	if (_exception_flag)
+	  {
+	    std::lock_guard<std::mutex> lock(_exception_mutex);
+	    _exception_flag = false;
+	    std::string data = _exception_data.str();
+	    _exception_data.str("");
+	    M_throw() << "Thread Exception found while waiting for tasks/threads to finish"
+		      << data;
+	  }
+      }
+
+      /*! \brief Execute func(i) for each i in [begin, end) and wait
+	for them to complete.
+
+	The range is split in half recursively. Each task pushes the
+	upper half of its range onto its worker's deque before working
+	on the lower half, so idle workers steal the largest remaining
+	pieces of work first.
+
+	\param grainSize The largest range executed as a single task.
+	If zero, the range is split into about 8 pieces per thread.
+       */
+      template<class Function>
+      inline void parallel_for(size_t begin, size_t end, Function func, size_t grainSize = 0)
+      {
+	if (end <= begin) return;
+
+	if (!grainSize)
+	  grainSize = std::max(size_t(1), (end - begin) / (8 * std::max(size_t(1), _threads.size())));
+
+	queueTask(std::bind(&WorkStealingPool::forRange<Function>, this, begin, end, func, grainSize));
+	wait();
+      }
+
+    private:
+      WorkStealingPool(const WorkStealingPool&);
+      WorkStealingPool& operator=(const WorkStealingPool&);
+
+      template<class Function>
+      void forRange(size_t begin, size_t end, Function func, size_t grainSize)
+      {
+	while (end - begin > grainSize)
+	  {
+	    const size_t mid = begin + (end - begin) / 2;
+	    queueTask(std::bind(&WorkStealingPool::forRange<Function>, this, mid, end, func, grainSize));
+	    end = mid;
+	  }
+
+	for (size_t i(begin); i != end; ++i)
+	  func(i);
+      }
+
+      /*! \brief The pool the current thread is a worker of (if any). */
+      static WorkStealingPool*& currentPool()
+      {
+	static thread_local WorkStealingPool* pool = nullptr;
+	return pool;
+      }
+
+      /*! \brief The index of the current thread in its pool. */
+      static size_t& currentWorker()
+      {
+	static thread_local size_t id = 0;
+	return id;
+      }
+
+      /*! \brief Wake sleeping threads if there are any.
+
+	The fence pairs with the one in beginThread(); either the
+	sleeping thread sees the new task when it checks the queues, or
+	this thread sees it is sleeping.
+       */
+      inline void wakeWorkers(bool all)
+      {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!_sleeping.load(std::memory_order_relaxed)) return;
+
+	//Taking the lock ensures the sleeper is waiting on the
+	//condition, and not between its check and the wait.
+	{ std::lock_guard<std::mutex> lock(_mutex); }
+	if (all)
+	  _work_condition.notify_all();
+	else
+	  _work_condition.notify_one();
+      }
+
+      inline void runTask(Task* task)
+      {
+	try { (*task)(); }
+	catch (std::exception& cep)
+	  {
+	    //Mark the main process to throw an exception as soon as possible
+	    std::lock_guard<std::mutex> lock(_exception_mutex);
+	    _exception_data << "\nTHREAD: Task threw an exception:-"
+			    << cep.what();
+	    _exception_flag = true;
+	  }
+	delete task;
+
+	if (_pending.fetch_sub(1) == 1)
+	  {
+	    std::lock_guard<std::mutex> lock(_mutex);
+	    _done_condition.notify_all();
+	  }
+      }
+
+      /*! \brief Look for a task to execute: first in the worker's own
+	deque, then by stealing from the other workers, and finally by
+	taking a share of the shared queue.
+       */
+      inline Task* findTask(size_t id)
+      {
+	Worker& self = *_workers[id];
+	Task* task = nullptr;
+	if (self.tasks.pop(task)) return task;
+
+	const size_t N = _workers.size();
+	const size_t start = self.RNG() % N;
+	for (size_t i(0); i < N; ++i)
+	  {
+	    const size_t victim = (start + i) % N;
+	    if ((victim != id) && _workers[victim]->tasks.steal(task))
+	      return task;
+	  }
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_injected.empty()) return nullptr;
+
+	//Take a fair share of the queue, keeping the rest on our
+	//deque where they may be stolen without locking.
+	const size_t share = std::max(size_t(1), _injected.size() / N);
+	task = _injected.front();
+	_injected.pop_front();
+	for (size_t i(1); i < share; ++i)
+	  {
+	    //Pushed in reverse so that pop() executes them in the order they were queued
+	    self.tasks.push(_injected[share - 1 - i]);
+	  }
+	_injected.erase(_injected.begin(), _injected.begin() + (share - 1));
+	return task;
+      }
+
+      inline bool workAvailable() const
+      {
+	if (!_injected.empty()) return true;
+	for (const auto& worker : _workers)
+	  if (!worker->tasks.empty()) return true;
+	return false;
+      }
+
+      /*! \brief Thread worker loop.
+       */
+      inline void beginThread(size_t id)
+      {
+	currentPool() = this;
+	currentWorker() = id;
+
+	while (true)
+	  {
+	    Task* task = findTask(id);
+	    if (task)
+	      {
+		runTask(task);
+		continue;
+	      }
+
+	    std::unique_lock<std::mutex> lock(_mutex);
+	    if (_stop_flag) break;
+	    _sleeping.fetch_add(1, std::memory_order_relaxed);
+	    std::atomic_thread_fence(std::memory_order_seq_cst);
+	    if (!workAvailable())
+	      _work_condition.wait(lock);
+	    _sleeping.fetch_sub(1, std::memory_order_relaxed);
+	  }
+
+	currentPool() = nullptr;
+      }
+
+      /*! \brief Terminate all the threads once all tasks are complete.
+       */
+      inline void stop()
+      {
+	{
+	  std::lock_guard<std::mutex> lock(_mutex);
+	  _stop_flag = true;
+	}
+	_work_condition.notify_all();
+	_threads.join_all();
+      }
+
+      std::vector<std::unique_ptr<Worker> > _workers;
+      magnet::thread::ThreadGroup _threads;
+
+      /*! \brief Tasks queued from outside of the pool (guarded by
+	  _mutex).
+       */
+      std::deque<Task*> _injected;
+      std::mutex _mutex;
+
+      /*! \brief Triggered to wake sleeping threads when tasks are
+          queued.
+       */
+      std::condition_variable _work_condition;
+
+      /*! \brief Triggered when the last pending task is completed, to
+          notify the mother thread stuck in the wait() function.
+       */
+      std::condition_variable _done_condition;
+
+      //! \brief The number of tasks queued but not yet completed.
+      std::atomic<size_t> _pending;
+      std::atomic<size_t> _sleeping;
+
+      std::mutex _exception_mutex;
+      std::ostringstream _exception_data;
+      std::atomic<bool> _exception_flag;
+      bool _stop_flag;
+    };
+  }
+}
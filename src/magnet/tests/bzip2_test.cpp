@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE Bzip2_Tests
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <magnet/compression/bzip2.hpp>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace magnet::compression;
+
+std::string test_data(size_t size)
+{
+  //Partly compressible data, similar to a configuration file
+  std::mt19937 RNG;
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::string data;
+  while (data.size() < size)
+    data += "<Pt ID=\"" + std::to_string(data.size()) + "\"><P x=\"" + std::to_string(dist(RNG)) + "\"/></Pt>\n";
+  data.resize(size);
+  return data;
+}
+
+std::string read_file(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void round_trip(size_t threads, size_t size)
+{
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(threads);
+  const std::string data = test_data(size);
+
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(bzip2_parallel_sink("bzip2_test.bz2", pool));
+    out.write(data.data(), data.size());
+  }
+
+  const std::string compressed = read_file("bzip2_test.bz2");
+  BOOST_CHECK(compressed.size() < data.size());
+
+  std::string output;
+  bzip2_parallel_decompress(compressed.data(), compressed.size(), output, pool);
+  BOOST_CHECK(output == data);
+}
+
+BOOST_AUTO_TEST_CASE( serial_round_trip )
+{ round_trip(0, 3000000); }
+
+BOOST_AUTO_TEST_CASE( parallel_round_trip )
+{ round_trip(4, 3000000); }
+
+BOOST_AUTO_TEST_CASE( parallel_small_round_trip )
+{ round_trip(4, 1000); }
+
+BOOST_AUTO_TEST_CASE( single_stream_decompress )
+{
+  //Data compressed by a standard (single stream) bzip2 compressor
+  //must still decompress correctly
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(4);
+  const std::string data = test_data(2000000);
+  std::string compressed;
+  detail::bzip2_compress_block(data.data(), data.size(), compressed, 9);
+
+  std::string output;
+  bzip2_parallel_decompress(compressed.data(), compressed.size(), output, pool);
+  BOOST_CHECK(output == data);
+}
+
+BOOST_AUTO_TEST_CASE( corrupt_data )
+{
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(4);
+  const std::string data = test_data(2000000);
+  std::string compressed;
+  detail::bzip2_compress_block(data.data(), data.size(), compressed, 9);
+  compressed.resize(compressed.size() / 2);
+
+  std::string output;
+  BOOST_CHECK_THROW(bzip2_parallel_decompress(compressed.data(), compressed.size(), output, pool), std::exception);
+}
@@ -0,0 +1,135 @@
+#define BOOST_TEST_MODULE FlatHashMap_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <magnet/containers/flat_hash_map.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <map>
+#include <unordered_map>
+
+const size_t N = 10000;
+const size_t Nrange = 100000;
+
+auto rng = std::mt19937(std::random_device()());
+auto IDgen = std::bind(std::uniform_int_distribution<size_t>(0, Nrange), rng);
+
+#define CompareContainers(test, reference)				\
+  {BOOST_CHECK_EQUAL(test.size(), reference.size());			\
+  typename std::remove_reference<decltype(reference)>::type copy(test.begin(), test.end()); \
+  BOOST_CHECK(copy == reference);}
+
+BOOST_AUTO_TEST_CASE( FlatHashMap_map )
+{
+  using namespace magnet::containers;
+  FlatHashMap<size_t, size_t> test;
+  std::map<size_t, size_t> reference;
+
+  //Test empty containers
+  BOOST_CHECK(test.begin() == test.end());
+  BOOST_CHECK(test.empty());
+  BOOST_CHECK(test.find(IDgen()) == test.end());
+
+  //Test inserts
+  for (size_t i(0); i < N; ++i)
+    {
+      FlatHashMap<size_t, size_t>::value_type value(IDgen(), IDgen());
+      BOOST_CHECK_EQUAL(test.insert(value).second, reference.insert(value).second);
+    }
+
+  CompareContainers(test, reference);
+
+  //Test array access operator writes
+  for (size_t i(0); i < N; ++i)
+    {
+      size_t key(IDgen()), value(IDgen());
+      test[key] = value;
+      reference[key] = value;
+    }
+
+  CompareContainers(test, reference);
+
+  //Test erase of 1/10th of known elements
+  for (size_t i(0); i < N / 10; ++i)
+    {
+      BOOST_CHECK_EQUAL(test.erase(reference.begin()->first), 1);
+      reference.erase(reference.begin()->first);
+    }
+
+  CompareContainers(test, reference);
+
+  //Test erase of randomly generated elements, which leaves runs of
+  //entries to be shifted back
+  for (size_t i(0); i < N; ++i)
+    {
+      size_t key(IDgen());
+      BOOST_CHECK_EQUAL(test.erase(key), reference.erase(key));
+    }
+
+  CompareContainers(test, reference);
+
+  //Test lookups of every key in the range
+  for (size_t key(0); key <= Nrange; ++key)
+    {
+      auto it = test.find(key);
+      auto refit = reference.find(key);
+      BOOST_CHECK_EQUAL(it == test.end(), refit == reference.end());
+      if ((it != test.end()) && (refit != reference.end()))
+	BOOST_CHECK_EQUAL(it->second, refit->second);
+    }
+
+  //Test copying
+  FlatHashMap<size_t, size_t> test2(test);
+  CompareContainers(test2, reference);
+
+  //Test clearing
+  test.clear();
+  BOOST_CHECK(test.size() == 0);
+  BOOST_CHECK(test.empty());
+  BOOST_CHECK(test.begin() == test.end());
+}
+
+//Particle pair keys, as used by the capture maps of DynamO
+uint64_t pairKey(uint32_t p1, uint32_t p2)
+{ return (uint64_t(std::max(p1, p2)) << 32) | std::min(p1, p2); }
+
+template<class Map>
+double benchmark(const std::vector<uint64_t>& keys, size_t loops)
+{
+  Map map;
+  size_t found = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t loop(0); loop < loops; ++loop)
+    {
+      for (const uint64_t key : keys)
+	map[key] = 1;
+      for (const uint64_t key : keys)
+	found += map.find(key) != map.end();
+      for (const uint64_t key : keys)
+	map.erase(key);
+    }
+  auto end = std::chrono::high_resolution_clock::now();
+  BOOST_CHECK_EQUAL(found, keys.size() * loops);
+  return std::chrono::duration<double>(end - start).count();
+}
+
+BOOST_AUTO_TEST_CASE( FlatHashMap_benchmark )
+{
+  //The captured pairs of a dense fluid of 100000 particles, where
+  //each particle captures ~6 particles with nearby IDs
+  const uint32_t Nparticles = 100000;
+  std::vector<uint64_t> keys;
+  std::uniform_int_distribution<uint32_t> offset(1, 50);
+  for (uint32_t p1(0); p1 < Nparticles; ++p1)
+    for (size_t i(0); i < 3; ++i)
+      keys.push_back(pairKey(p1, (p1 + offset(rng)) % Nparticles));
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  const size_t loops = 5;
+  std::cout << "Benchmark: " << loops << " rounds of inserting, finding and erasing " << keys.size() << " pair keys\n"
+	    << "std::map           " << benchmark<std::map<uint64_t, size_t> >(keys, loops) << "s\n"
+	    << "std::unordered_map " << benchmark<std::unordered_map<uint64_t, size_t> >(keys, loops) << "s\n"
+	    << "FlatHashMap        " << benchmark<magnet::containers::FlatHashMap<uint64_t, size_t> >(keys, loops) << "s\n";
+}
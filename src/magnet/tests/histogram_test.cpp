@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE Histogram_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <magnet/containers/dense_bin_map.hpp>
+#include <magnet/containers/fuzzy_array.hpp>
+#include <magnet/math/histogram.hpp>
+#include <chrono>
+#include <limits>
+#include <iostream>
+#include <map>
+#include <random>
+
+using magnet::containers::DenseBinMap;
+using magnet::containers::FuzzyArray;
+
+#define CompareContainers(test, reference)				\
+  {BOOST_CHECK_EQUAL(test.size(), reference.size());			\
+    std::map<long, double> copy;					\
+    for (const auto& bin : test) copy[bin.first] = bin.second;		\
+    BOOST_CHECK(copy == reference);					\
+    long last = std::numeric_limits<long>::min();			\
+    for (const auto& bin : test) { BOOST_CHECK(bin.first > last); last = bin.first; }}
+
+BOOST_AUTO_TEST_CASE( DenseBinMap_map )
+{
+  DenseBinMap<double, 1024> test;
+  std::map<long, double> reference;
+  BOOST_CHECK(test.empty());
+  BOOST_CHECK(test.begin() == test.end());
+
+  //Fill bins in both directions from the first bin, including bins
+  //which are accessed but hold zero
+  std::mt19937 RNG;
+  std::normal_distribution<double> normal(0, 50);
+  for (size_t i(0); i < 10000; ++i)
+    {
+      const long key = std::lrint(normal(RNG));
+      const double weight = (i % 10) ? 1.0 : 0.0;
+      test[key] += weight;
+      reference[key] += weight;
+    }
+
+  BOOST_CHECK(!test.isSparse());
+  CompareContainers(test, reference);
+
+  //An outlier beyond the dense range falls back to a map
+  test[100000] += 2;
+  reference[100000] += 2;
+  BOOST_CHECK(test.isSparse());
+  CompareContainers(test, reference);
+
+  test[-3] += 1;
+  reference[-3] += 1;
+  CompareContainers(test, reference);
+
+  //Clearing returns to dense storage
+  test.clear();
+  BOOST_CHECK(test.empty());
+  BOOST_CHECK(!test.isSparse());
+  BOOST_CHECK(test.begin() == test.end());
+}
+
+BOOST_AUTO_TEST_CASE( DenseBinMap_limit )
+{
+  //A span of exactly MaxDenseBins stays dense, however the bins
+  //are grown
+  DenseBinMap<double, 1024> test;
+  std::map<long, double> reference;
+  for (long key(600); key < 1024; ++key)
+    { test[key] += 1; reference[key] += 1; }
+  for (long key(599); key >= 0; --key)
+    { test[key] += 1; reference[key] += 1; }
+  BOOST_CHECK(!test.isSparse());
+  CompareContainers(test, reference);
+
+  //One more bin exceeds the limit
+  test[1024] += 1;
+  reference[1024] += 1;
+  BOOST_CHECK(test.isSparse());
+  CompareContainers(test, reference);
+}
+
+BOOST_AUTO_TEST_CASE( Histogram_output )
+{
+  //The dense backend must give identical output to the original
+  //map based FuzzyArray
+  magnet::math::Histogram<> hist(0.1);
+  FuzzyArray<unsigned long> reference(0.1);
+
+  std::mt19937 RNG;
+  std::normal_distribution<double> normal(0, 1);
+  for (size_t i(0); i < 10000; ++i)
+    {
+      const double val = normal(RNG);
+      hist.addVal(val);
+      ++reference[val];
+    }
+
+  BOOST_CHECK_EQUAL(hist.getSampleCount(), 10000);
+  BOOST_CHECK_EQUAL(hist.size(), reference.size());
+  auto it = reference.begin();
+  for (const auto& bin : hist)
+    {
+      BOOST_CHECK_EQUAL(bin.first, it->first);
+      BOOST_CHECK_EQUAL(bin.second, it->second);
+      ++it;
+    }
+}
+
+template<class Container>
+double benchmark(const std::vector<double>& values, size_t loops)
+{
+  Container hist(0.01);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t loop(0); loop < loops; ++loop)
+    for (const double val : values)
+      hist[val] += 1;
+  auto end = std::chrono::high_resolution_clock::now();
+
+  double total = 0;
+  for (const auto& bin : hist) total += bin.second;
+  BOOST_CHECK_EQUAL(total, values.size() * loops);
+  return std::chrono::duration<double>(end - start).count();
+}
+
+BOOST_AUTO_TEST_CASE( Histogram_benchmark )
+{
+  //Samples of an energy like property spread over ~1000 bins
+  std::mt19937 RNG;
+  std::normal_distribution<double> normal(0, 2);
+  std::vector<double> values(1000000);
+  for (double& val : values) val = normal(RNG);
+
+  const size_t loops = 5;
+  std::cout << "Benchmark: " << loops << " rounds of binning " << values.size() << " samples\n"
+	    << "std::map    " << benchmark<FuzzyArray<double> >(values, loops) << "s\n"
+	    << "DenseBinMap " << benchmark<FuzzyArray<double, false, DenseBinMap<double> > >(values, loops) << "s\n";
+}
@@ -3,6 +3,9 @@
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <magnet/containers/judy.hpp>
+#include <magnet/containers/flat_hash_map.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <set>
 #include <map>
@@ -131,3 +134,44 @@ BOOST_AUTO_TEST_CASE( Judy_map )
   BOOST_CHECK(test.empty());
   BOOST_CHECK(test.begin() == test.end());
 }
+
+template<class Map>
+double benchmark(const std::vector<size_t>& keys, size_t loops)
+{
+  Map map;
+  size_t found = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t loop(0); loop < loops; ++loop)
+    {
+      for (const size_t key : keys)
+	map[key] = 1;
+      for (const size_t key : keys)
+	found += map.find(key) != map.end();
+      for (const size_t key : keys)
+	map.erase(key);
+    }
+  auto end = std::chrono::high_resolution_clock::now();
+  BOOST_CHECK_EQUAL(found, keys.size() * loops);
+  return std::chrono::duration<double>(end - start).count();
+}
+
+BOOST_AUTO_TEST_CASE( Judy_map_benchmark )
+{
+  //Particle pair keys (see dynamo::detail::PairKey), where each of
+  //100000 particles captures ~6 particles with nearby IDs
+  const size_t Nparticles = 100000;
+  std::vector<size_t> keys;
+  std::uniform_int_distribution<size_t> offset(1, 50);
+  for (size_t p1(0); p1 < Nparticles; ++p1)
+    for (size_t i(0); i < 3; ++i)
+      {
+	const size_t p2 = (p1 + offset(rng)) % Nparticles;
+	keys.push_back((std::max(p1, p2) << 32) | std::min(p1, p2));
+      }
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  const size_t loops = 5;
+  std::cout << "Benchmark: " << loops << " rounds of inserting, finding and erasing " << keys.size() << " pair keys\n"
+	    << "JudyMap     " << benchmark<magnet::containers::JudyMap<size_t, size_t> >(keys, loops) << "s\n"
+	    << "FlatHashMap " << benchmark<magnet::containers::FlatHashMap<size_t, size_t> >(keys, loops) << "s\n";
+}
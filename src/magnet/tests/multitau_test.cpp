@@ -0,0 +1,96 @@
+#define BOOST_TEST_MODULE MultiTau_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <magnet/math/correlators.hpp>
+#include <map>
+#include <random>
+
+using magnet::math::Vector;
+
+struct SquaredDisplacement
+{
+  double operator()(const Vector& origin, const Vector& now) const
+  { return (now - origin).nrm2(); }
+};
+
+typedef magnet::math::MultiTauCorrelator<Vector, SquaredDisplacement> MSDCorrelator;
+
+BOOST_AUTO_TEST_CASE( MultiTau_ballistic )
+{
+  //Particles moving at constant velocities, split into two groups
+  //with different speeds, have an MSD of (v t)^2
+  const size_t N = 10, steps = 5000;
+  MSDCorrelator correlator;
+  correlator.resize(std::vector<size_t>{4, N}, 8, 2);
+
+  std::vector<Vector> sample(N);
+  for (size_t t(0); t < steps; ++t)
+    {
+      for (size_t i(0); i < N; ++i)
+	sample[i] = Vector((i < 4) ? 1 : 2, 0, 0) * double(t);
+      correlator.push(sample);
+    }
+
+  for (size_t group(0); group < 2; ++group)
+    {
+      const double v = (group == 0) ? 1 : 2;
+      std::vector<MSDCorrelator::Data> data = correlator.getAveragedCorrelator(group);
+      BOOST_REQUIRE(!data.empty());
+      BOOST_CHECK_EQUAL(data.front().lag, 0);
+
+      //The lags must be strictly increasing and reach the length of
+      //the run within a factor of the scaling
+      for (size_t i(1); i < data.size(); ++i)
+	BOOST_CHECK(data[i].lag > data[i-1].lag);
+      BOOST_CHECK(data.back().lag * 2 >= steps / 2);
+      BOOST_CHECK(data.back().lag < steps);
+
+      for (const MSDCorrelator::Data& entry : data)
+	BOOST_CHECK_CLOSE(entry.value + 1, v * v * entry.lag * entry.lag + 1, 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( MultiTau_random_walk )
+{
+  //Compare against a brute force MSD of a random walk, using every
+  //time origin the multi-tau correlator sees
+  const size_t N = 5, steps = 2000, points = 16, scaling = 4;
+  std::mt19937 RNG;
+  std::normal_distribution<double> normal(0, 1);
+
+  MSDCorrelator correlator;
+  correlator.resize(std::vector<size_t>{N}, points, scaling);
+
+  std::vector<std::vector<Vector> > history;
+  std::vector<Vector> sample(N, Vector(0,0,0));
+  for (size_t t(0); t < steps; ++t)
+    {
+      for (Vector& pos : sample)
+	pos += Vector(normal(RNG), normal(RNG), normal(RNG));
+      correlator.push(sample);
+      history.push_back(sample);
+    }
+
+  std::vector<MSDCorrelator::Data> data = correlator.getAveragedCorrelator(0);
+  BOOST_REQUIRE(!data.empty());
+  for (const MSDCorrelator::Data& entry : data)
+    {
+      //Find the block size of the level this lag was sampled on
+      size_t stride = 1;
+      while (entry.lag >= points * stride) stride *= scaling;
+
+      //The time origins of a level (other than the first) start at
+      //its stride, the first time it is sampled
+      double sum = 0;
+      size_t origins = 0;
+      for (size_t t0((stride == 1) ? 0 : stride); t0 + entry.lag < steps; t0 += stride)
+	{
+	  for (size_t i(0); i < N; ++i)
+	    sum += (history[t0 + entry.lag][i] - history[t0][i]).nrm2();
+	  ++origins;
+	}
+
+      BOOST_CHECK_EQUAL(entry.sample_count, origins);
+      BOOST_CHECK_CLOSE(entry.value + 1, sum / (origins * N) + 1, 1e-8);
+    }
+}
@@ -0,0 +1,59 @@
+#define BOOST_TEST_MODULE Sphere_Intersection_Tests
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
+#include <vector>
+#include <random>
+
+std::mt19937 RNG;
+std::normal_distribution<double> normal_dist(0.0, 1.0);
+std::uniform_int_distribution<int> case_dist(0, 3);
+using namespace magnet::math;
+
+Vector random_vec() {
+  return Vector(normal_dist(RNG), normal_dist(RNG), normal_dist(RNG));
+}
+
+const size_t testcount = 10000;
+
+template<bool inverse>
+void batchTest()
+{
+  RNG.seed();
+
+  std::vector<Vector> R, V;
+  std::vector<double> R2, RV, V2, sig, dt(testcount);
+  for (size_t i(0); i < testcount; ++i)
+    {
+      Vector r = random_vec(), v = random_vec();
+      double d = std::abs(normal_dist(RNG));
+      //Generate the special cases of the algorithm: stationary
+      //rays, rays starting on the surface of the sphere, and
+      //receding rays.
+      switch (case_dist(RNG))
+	{
+	case 0: v = Vector(0, 0, 0); break;
+	case 1: d = r.nrm(); break;
+	case 2: if ((r | v) < 0) v = -v; break;
+	default: break;
+	}
+
+      R.push_back(r);
+      V.push_back(v);
+      R2.push_back(r.nrm2());
+      RV.push_back(r | v);
+      V2.push_back(v.nrm2());
+      sig.push_back(d);
+    }
+
+  magnet::intersection::ray_sphere<inverse>(R2.data(), RV.data(), V2.data(), sig.data(), dt.data(), testcount);
+
+  for (size_t i(0); i < testcount; ++i)
+    BOOST_CHECK_EQUAL(dt[i], magnet::intersection::ray_sphere<inverse>(R[i], V[i], sig[i]));
+}
+
+BOOST_AUTO_TEST_CASE( Batched_Ray_Sphere_Test )
+{ batchTest<false>(); }
+
+BOOST_AUTO_TEST_CASE( Batched_Inverse_Ray_Sphere_Test )
+{ batchTest<true>(); }
@@ -0,0 +1,65 @@
+#define BOOST_TEST_MODULE SphericalHarmonics_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/math/special_functions/spherical_harmonic.hpp>
+#include <magnet/math/spherical_harmonics.hpp>
+#include <random>
+
+BOOST_AUTO_TEST_CASE( SphericalHarmonics_boost )
+{
+  //Compare the recurrence against boost for a block of random
+  //directions
+  const size_t L = 13, N = 37;
+  std::mt19937 RNG;
+  std::normal_distribution<double> normal(0, 1);
+
+  std::vector<double> z, x, y;
+  std::vector<std::complex<double> > reference(magnet::math::SphericalHarmonicSum::index(L, 0));
+  for (size_t j(0); j < N; ++j)
+    {
+      double r[3] = {normal(RNG), normal(RNG), normal(RNG)};
+      const double norm = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+      z.push_back(r[0] / norm);
+      x.push_back(r[1] / norm);
+      y.push_back(r[2] / norm);
+
+      const double theta = std::acos(z.back());
+      const double phi = std::atan2(y.back(), x.back());
+      for (size_t l(0); l < L; ++l)
+	for (size_t m(0); m <= l; ++m)
+	  reference[magnet::math::SphericalHarmonicSum::index(l, m)] += boost::math::spherical_harmonic(l, m, theta, phi);
+    }
+
+  magnet::math::SphericalHarmonicSum harmonics(L);
+  BOOST_CHECK_EQUAL(harmonics.size(), reference.size());
+  std::vector<std::complex<double> > sums(harmonics.size());
+  harmonics.accumulate(z.data(), x.data(), y.data(), N, sums.data());
+
+  for (size_t i(0); i < sums.size(); ++i)
+    {
+      BOOST_CHECK_SMALL(sums[i].real() - reference[i].real(), 1e-10);
+      BOOST_CHECK_SMALL(sums[i].imag() - reference[i].imag(), 1e-10);
+    }
+
+  //The sums accumulate, and reusing the scratch space is safe
+  harmonics.accumulate(z.data(), x.data(), y.data(), N, sums.data());
+  for (size_t i(0); i < sums.size(); ++i)
+    BOOST_CHECK_SMALL(std::abs(sums[i] - 2.0 * reference[i]), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE( SphericalHarmonics_poles )
+{
+  //Along the polar axis only the m=0 terms are non-zero
+  const size_t L = 8;
+  const double z = 1, x = 0, y = 0;
+  magnet::math::SphericalHarmonicSum harmonics(L);
+  std::vector<std::complex<double> > sums(harmonics.size());
+  harmonics.accumulate(&z, &x, &y, 1, sums.data());
+
+  for (size_t l(0); l < L; ++l)
+    for (size_t m(0); m <= l; ++m)
+      {
+	const double expected = (m == 0) ? std::sqrt((2.0 * l + 1) / (4 * M_PI)) : 0;
+	BOOST_CHECK_SMALL(std::abs(sums[magnet::math::SphericalHarmonicSum::index(l, m)] - expected), 1e-12);
+      }
+}
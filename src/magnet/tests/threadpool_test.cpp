@@ -1,7 +1,10 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
 #include <magnet/thread/threadpool.hpp>
+#include <magnet/thread/workstealingpool.hpp>
 
 std::vector<float> sums;
 
@@ -33,14 +36,15 @@ struct A
   { std::cerr << "Inside memberfunc3, i=" << i << ", j=" << j << "\n"; }
 };
 
-int main()
+template<class Pool>
+void test_pool()
 {
   int N = 1000;
   sums.resize(N);
 
   A Aclass;
 
-  magnet::thread::ThreadPool pool;
+  Pool pool;
 
   pool.setThreadCount(4);
 
@@ -94,6 +98,102 @@ int main()
 	}
     }
 
+}
+
+std::atomic<size_t> counter;
+
+void nested(magnet::thread::WorkStealingPool& pool, size_t depth)
+{
+  ++counter;
+  if (depth)
+    {
+      pool.queueTask(std::bind(nested, std::ref(pool), depth - 1));
+      pool.queueTask(std::bind(nested, std::ref(pool), depth - 1));
+    }
+}
+
+void test_workstealing()
+{
+  magnet::thread::WorkStealingPool pool;
+  pool.setThreadCount(4);
+
+  //Tasks queuing tasks onto their own deques
+  counter = 0;
+  pool.queueTask(std::bind(nested, std::ref(pool), 12));
+  pool.wait();
+  if (counter != (size_t(1) << 13) - 1)
+    throw std::runtime_error("Nested tasks were lost");
+
+  //Batch queuing
+  counter = 0;
+  std::vector<std::function<void()> > tasks(10000, [](){ ++counter; });
+  pool.queueTasks(tasks);
+  pool.wait();
+  if (counter != 10000)
+    throw std::runtime_error("Batched tasks were lost");
+
+  //Parallel for, with each index visited exactly once
+  std::vector<size_t> visits(100000, 0);
+  pool.parallel_for(0, visits.size(), [&](size_t i) { ++visits[i]; });
+  for (size_t v : visits)
+    if (v != 1)
+      throw std::runtime_error("Parallel for visited an index more or less than once");
+
+  //Exceptions are passed back to the waiting thread
+  pool.queueTask([](){ throw std::runtime_error("Test exception"); });
+  bool thrown = false;
+  try { pool.wait(); }
+  catch (std::exception&) { thrown = true; }
+  if (!thrown)
+    throw std::runtime_error("Task exception was not passed to wait()");
+
+  //The 0 thread mode executes the tasks (and any tasks they queue) in wait()
+  pool.setThreadCount(0);
+  counter = 0;
+  pool.queueTask(std::bind(nested, std::ref(pool), 6));
+  pool.wait();
+  if (counter != (size_t(1) << 7) - 1)
+    throw std::runtime_error("Nested tasks were lost in 0 thread mode");
+}
+
+template<class Pool>
+double benchmark(size_t threads, size_t replicas, size_t loops)
+{
+  Pool pool;
+  pool.setThreadCount(threads);
+
+  //Many short tasks, such as a replica exchange run with many small
+  //replicas
+  std::vector<float> results(replicas);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t loop(0); loop < loops; ++loop)
+    {
+      for (size_t i(0); i < replicas; ++i)
+	pool.queueTask([&results, i]() { 
+	    float sum = 0;
+	    for (size_t j(0); j < 100; ++j)
+	      sum += j * i;
+	    results[i] = sum;
+	  });
+      pool.wait();
+    }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main()
+{
+  std::cerr << "Testing ThreadPool\n";
+  test_pool<magnet::thread::ThreadPool>();
+  std::cerr << "Testing WorkStealingPool\n";
+  test_pool<magnet::thread::WorkStealingPool>();
+  test_workstealing();
+
+  const size_t threads = 4, replicas = 500, loops = 200;
+  std::cerr << "Benchmark: " << loops << " rounds of " << replicas << " short tasks on " << threads << " threads\n"
+	    << "ThreadPool       " << benchmark<magnet::thread::ThreadPool>(threads, replicas, loops) << "s\n"
+	    << "WorkStealingPool " << benchmark<magnet::thread::WorkStealingPool>(threads, replicas, loops) << "s\n";
+
   std::cerr << "Finished\n";
 
   return 0;